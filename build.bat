@@ -17,8 +17,30 @@ REM Default Compiler Flags
 REM We assume headers/libs are in standard search path OR environment variables
 REM You might need to add -I"C:\SDL2\include" -L"C:\SDL2\lib" if not in standard path.
 
-g++ -std=c++17 -Iinclude src/Game.cpp src/StunClient.cpp src/Utils.cpp src/Player.cpp src/main.cpp -o amphitude.exe -lmingw32 -lSDL2main -lSDL2 -lSDL2_image -lSDL2_ttf -lSDL2_net
+g++ -std=c++17 -Iinclude src/BakedArenas.cpp src/Bot.cpp src/Game.cpp src/Level.cpp src/StunClient.cpp src/Utils.cpp src/Player.cpp src/main.cpp -o amphitude.exe -lmingw32 -lSDL2main -lSDL2 -lSDL2_image -lSDL2_ttf -lSDL2_net
 
+if %errorlevel% neq 0 goto failed
+
+REM Headless match simulator (same sources minus main.cpp)
+g++ -std=c++17 -O2 -Iinclude tools/amphitude_sim.cpp src/BakedArenas.cpp src/Bot.cpp src/Game.cpp src/Level.cpp src/StunClient.cpp src/Utils.cpp src/Player.cpp -o amphitude-sim.exe -lSDL2 -lSDL2_image -lSDL2_ttf -lSDL2_net
+
+if %errorlevel% neq 0 goto failed
+
+REM Online loopback check (host and client in one process); fails on a desync
+g++ -std=c++17 -O2 -Iinclude tools/amphitude_loopback.cpp src/BakedArenas.cpp src/Bot.cpp src/Game.cpp src/Level.cpp src/StunClient.cpp src/Utils.cpp src/Player.cpp -o amphitude-loopback.exe -lSDL2 -lSDL2_image -lSDL2_ttf -lSDL2_net
+if %errorlevel% neq 0 goto failed
+amphitude-loopback.exe >nul
+if %errorlevel% neq 0 goto failed
+
+REM Level compiler and bundled arenas (the game falls back to a built-in arena without them)
+g++ -std=c++17 -O2 -Iinclude tools/amphitude_levelc.cpp -o amphitude-levelc.exe
+if %errorlevel% neq 0 goto failed
+for %%f in (assets\levels\*.txt) do amphitude-levelc.exe "%%f" "assets\levels\%%~nf.lvl" || goto failed
+
+REM Collision benchmark (no SDL)
+g++ -std=c++17 -O2 -Iinclude tools/amphitude_collide_bench.cpp -o amphitude-collide-bench.exe
+
+:failed
 if %errorlevel% equ 0 (
     echo ✅ Build Successful!
     echo 👉 Run: amphitude.exe
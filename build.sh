@@ -31,6 +31,10 @@ elif [ "$OS" == "Linux" ]; then
     else
         echo "⚠️  pkg-config not found. Using default flags."
     fi
+    # shm_open/shm_unlink (same-machine transport) live in librt on older glibc
+    LIBS="$LIBS -lrt"
+    # std::thread (job system) needs libpthread on older glibc
+    CXXFLAGS="$CXXFLAGS -pthread"
 
 elif [[ "$OS" == MINGW* ]] || [[ "$OS" == CYGWIN* ]] || [[ "$OS" == MSYS* ]]; then
     # Windows (Git Bash / MSYS2)
@@ -45,8 +49,9 @@ fi
 build_target() {
     NAME=$1
     SRC=$2
+    TARGET_LIBS=${3-$LIBS} # Optional: override libraries (e.g. "" for tools without SDL)
     echo "🔨 Building $NAME..."
-    $CXX $CXXFLAGS $SRC -o $NAME$OUTPUT_EXT $LIBS
+    $CXX $CXXFLAGS $SRC -o $NAME$OUTPUT_EXT $TARGET_LIBS
     
     if [ $? -eq 0 ]; then
         echo "✅ $NAME built successfully!"
@@ -65,6 +70,34 @@ build_target() {
 # Build Game
 build_target "amphitude" "src/*.cpp"
 
+# Build Headless Simulator (the game without main.cpp; no window is opened)
+SIM_SRC=$(ls src/*.cpp | grep -v 'src/main.cpp')
+build_target "amphitude-sim" "-O2 tools/amphitude_sim.cpp $SIM_SRC"
+
+# Build Online Loopback Check (host and client in one process) and run it
+build_target "amphitude-loopback" "-O2 tools/amphitude_loopback.cpp $SIM_SRC"
+./amphitude-loopback$OUTPUT_EXT > /dev/null || { echo "❌ Loopback match reported a desync."; exit 1; }
+
+# Build Level Compiler (no SDL) and compile the bundled arenas
+build_target "amphitude-levelc" "-O2 tools/amphitude_levelc.cpp" ""
+for LEVEL_SRC in assets/levels/*.txt; do
+    ./amphitude-levelc$OUTPUT_EXT "$LEVEL_SRC" "${LEVEL_SRC%.txt}.lvl" || exit 1
+done
+
+# Build Collision Benchmark (no SDL): per-pair test vs the batch kernels
+build_target "amphitude-collide-bench" "-O2 tools/amphitude_collide_bench.cpp" ""
+
+# Build Relay Server (optional, POSIX sockets only)
+if [ -z "$OUTPUT_EXT" ]; then
+    build_target "amphitude-relay" "-O2 tools/amphitude_relay.cpp" ""
+fi
+
 echo ""
 echo "🎉 Build Complete!"
 echo "👉 Run Game:   ./amphitude$OUTPUT_EXT"
+echo "👉 Pick Arena: AMPHITUDE_LEVEL=assets/levels/<name>.lvl ./amphitude$OUTPUT_EXT"
+echo "👉 Simulate:   ./amphitude-sim --matches 1000 [--players N]"
+echo "👉 Benchmark:  ./amphitude-collide-bench [--boxes N]"
+if [ -z "$OUTPUT_EXT" ]; then
+    echo "👉 Run Relay:  ./amphitude-relay [port]"
+fi
@@ -0,0 +1,237 @@
+#ifndef AABBBATCH_H
+#define AABBBATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AABB_BATCH_X86 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define AABB_BATCH_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define AABB_BATCH_NEON 1 // AArch64 only: the mask uses vaddvq_u32
+#include <arm_neon.h>
+#endif
+
+/**
+ * @namespace AabbBatch
+ * @brief One box against many: overlap tests over packed (SoA) box columns.
+ *
+ * The narrow phase asks "which of these boxes does this one touch?" Instead
+ * of one checkCollision() call per pair, the kernels compare the query box
+ * with 4 (SSE2, NEON on AArch64) or 8 (AVX2) boxes per instruction and write a hit mask,
+ * bit i = box i. The comparisons are the same as checkCollision(), so the
+ * masks are bit-identical to the scalar test on every kernel.
+ *
+ * The kernel is picked once at run time: the best one the CPU supports (AVX2
+ * is compiled with a target attribute, so the build needs no -mavx2), or the
+ * one named by AMPHITUDE_SIMD=scalar|sse2|avx2|neon.
+ *
+ * Columns padded up to paddedCount() with boxes at (FAR, FAR) never leave a
+ * scalar tail, and the padding never reports a hit.
+ */
+namespace AabbBatch {
+    enum Kernel { SCALAR, SSE2, AVX2, NEON, KERNEL_COUNT };
+
+    /** @brief Widest kernel; pad columns to a multiple of this. */
+    constexpr size_t LANES = 8;
+
+    /** @brief Coordinate of a padding box: nothing overlaps it. */
+    constexpr float FAR = 3.0e38f;
+
+    /** @brief Read-only SoA view of `count` boxes (top-left x/y, width, height). */
+    struct Boxes {
+        const float* x;
+        const float* y;
+        const float* w;
+        const float* h;
+        size_t count;
+    };
+
+    constexpr size_t paddedCount(size_t count) { return (count + LANES - 1) / LANES * LANES; }
+    constexpr size_t maskWords(size_t count) { return (count + 63) / 64; }
+
+    namespace detail {
+        inline size_t scalar(float x, float y, float w, float h, const Boxes& b, size_t begin, uint64_t* mask) {
+            float right = x + w, bottom = y + h;
+            size_t hits = 0;
+            for (size_t i = begin; i < b.count; ++i) {
+                if (x < b.x[i] + b.w[i] && right > b.x[i] && y < b.y[i] + b.h[i] && bottom > b.y[i]) {
+                    mask[i >> 6] |= uint64_t(1) << (i & 63);
+                    ++hits;
+                }
+            }
+            return hits;
+        }
+
+        inline int popcount8(unsigned bits) {
+            int n = 0;
+            for (; bits; bits &= bits - 1) ++n;
+            return n;
+        }
+
+#if AABB_BATCH_X86
+        inline size_t sse2(float x, float y, float w, float h, const Boxes& b, uint64_t* mask) {
+            __m128 qx = _mm_set1_ps(x), qy = _mm_set1_ps(y);
+            __m128 qr = _mm_set1_ps(x + w), qb = _mm_set1_ps(y + h);
+            size_t hits = 0, i = 0;
+            for (; i + 4 <= b.count; i += 4) {
+                __m128 bx = _mm_loadu_ps(b.x + i), by = _mm_loadu_ps(b.y + i);
+                __m128 hit = _mm_and_ps(
+                    _mm_and_ps(_mm_cmplt_ps(qx, _mm_add_ps(bx, _mm_loadu_ps(b.w + i))), _mm_cmpgt_ps(qr, bx)),
+                    _mm_and_ps(_mm_cmplt_ps(qy, _mm_add_ps(by, _mm_loadu_ps(b.h + i))), _mm_cmpgt_ps(qb, by)));
+                unsigned bits = static_cast<unsigned>(_mm_movemask_ps(hit));
+                if (bits) {
+                    mask[i >> 6] |= uint64_t(bits) << (i & 63);
+                    hits += popcount8(bits);
+                }
+            }
+            return hits + scalar(x, y, w, h, b, i, mask);
+        }
+#endif
+
+#if AABB_BATCH_AVX2
+        __attribute__((target("avx2")))
+        inline size_t avx2(float x, float y, float w, float h, const Boxes& b, uint64_t* mask) {
+            __m256 qx = _mm256_set1_ps(x), qy = _mm256_set1_ps(y);
+            __m256 qr = _mm256_set1_ps(x + w), qb = _mm256_set1_ps(y + h);
+            size_t hits = 0, i = 0;
+            for (; i + 8 <= b.count; i += 8) {
+                __m256 bx = _mm256_loadu_ps(b.x + i), by = _mm256_loadu_ps(b.y + i);
+                __m256 right = _mm256_add_ps(bx, _mm256_loadu_ps(b.w + i));
+                __m256 bottom = _mm256_add_ps(by, _mm256_loadu_ps(b.h + i));
+                __m256 hit = _mm256_and_ps(
+                    _mm256_and_ps(_mm256_cmp_ps(qx, right, _CMP_LT_OQ), _mm256_cmp_ps(qr, bx, _CMP_GT_OQ)),
+                    _mm256_and_ps(_mm256_cmp_ps(qy, bottom, _CMP_LT_OQ), _mm256_cmp_ps(qb, by, _CMP_GT_OQ)));
+                unsigned bits = static_cast<unsigned>(_mm256_movemask_ps(hit));
+                if (bits) {
+                    mask[i >> 6] |= uint64_t(bits) << (i & 63);
+                    hits += popcount8(bits);
+                }
+            }
+            return hits + scalar(x, y, w, h, b, i, mask);
+        }
+#endif
+
+#if AABB_BATCH_NEON
+        inline size_t neon(float x, float y, float w, float h, const Boxes& b, uint64_t* mask) {
+            float32x4_t qx = vdupq_n_f32(x), qy = vdupq_n_f32(y);
+            float32x4_t qr = vdupq_n_f32(x + w), qb = vdupq_n_f32(y + h);
+            const uint32x4_t laneBits = {1, 2, 4, 8};
+            size_t hits = 0, i = 0;
+            for (; i + 4 <= b.count; i += 4) {
+                float32x4_t bx = vld1q_f32(b.x + i), by = vld1q_f32(b.y + i);
+                uint32x4_t hit = vandq_u32(
+                    vandq_u32(vcltq_f32(qx, vaddq_f32(bx, vld1q_f32(b.w + i))), vcgtq_f32(qr, bx)),
+                    vandq_u32(vcltq_f32(qy, vaddq_f32(by, vld1q_f32(b.h + i))), vcgtq_f32(qb, by)));
+                unsigned bits = vaddvq_u32(vandq_u32(hit, laneBits));
+                if (bits) {
+                    mask[i >> 6] |= uint64_t(bits) << (i & 63);
+                    hits += popcount8(bits);
+                }
+            }
+            return hits + scalar(x, y, w, h, b, i, mask);
+        }
+#endif
+    }
+
+    inline const char* kernelName(Kernel k) {
+        const char* names[KERNEL_COUNT] = {"scalar", "sse2", "avx2", "neon"};
+        return names[k];
+    }
+
+    /** @brief Whether this build and CPU can run kernel `k`. */
+    inline bool available(Kernel k) {
+        switch (k) {
+            case SCALAR: return true;
+#if AABB_BATCH_X86
+            case SSE2: return true;
+#endif
+#if AABB_BATCH_AVX2
+            case AVX2: return __builtin_cpu_supports("avx2") != 0;
+#endif
+#if AABB_BATCH_NEON
+            case NEON: return true;
+#endif
+            default: return false;
+        }
+    }
+
+    /** @brief The kernel overlaps() uses: AMPHITUDE_SIMD if available, else the widest one. */
+    inline Kernel active() {
+        static const Kernel chosen = [] {
+            const char* env = getenv("AMPHITUDE_SIMD");
+            for (int k = 0; env && k < KERNEL_COUNT; ++k) {
+                Kernel kernel = static_cast<Kernel>(k);
+                if (available(kernel) && strcmp(env, kernelName(kernel)) == 0) return kernel;
+            }
+            Kernel widest = SCALAR;
+            for (int k = SCALAR + 1; k < KERNEL_COUNT; ++k) {
+                if (available(static_cast<Kernel>(k))) widest = static_cast<Kernel>(k);
+            }
+            return widest;
+        }();
+        return chosen;
+    }
+
+    /**
+     * @brief Sets bit i of `mask` for every box i that overlaps (x, y, w, h).
+     * @param mask maskWords(boxes.count) words; cleared first.
+     * @param k Kernel to use; must be available().
+     * @return Number of hits.
+     */
+    inline size_t overlaps(Kernel k, float x, float y, float w, float h, const Boxes& boxes, uint64_t* mask) {
+        memset(mask, 0, maskWords(boxes.count) * sizeof(uint64_t));
+        switch (k) {
+#if AABB_BATCH_X86
+            case SSE2: return detail::sse2(x, y, w, h, boxes, mask);
+#endif
+#if AABB_BATCH_AVX2
+            case AVX2: return detail::avx2(x, y, w, h, boxes, mask);
+#endif
+#if AABB_BATCH_NEON
+            case NEON: return detail::neon(x, y, w, h, boxes, mask);
+#endif
+            default: return detail::scalar(x, y, w, h, boxes, 0, mask);
+        }
+    }
+
+    inline size_t overlaps(float x, float y, float w, float h, const Boxes& boxes, uint64_t* mask) {
+        return overlaps(active(), x, y, w, h, boxes, mask);
+    }
+
+    namespace detail {
+        inline size_t lowestBit(uint64_t bits) {
+#if defined(__GNUC__)
+            return static_cast<size_t>(__builtin_ctzll(bits));
+#else
+            size_t bit = 0;
+            for (; !((bits >> bit) & 1); ) ++bit;
+            return bit;
+#endif
+        }
+    }
+
+    /** @brief Calls fn(index) for every set bit, in ascending index order. */
+    template <typename Fn>
+    void forEachHit(const uint64_t* mask, size_t count, Fn fn) {
+        for (size_t word = 0; word < maskWords(count); ++word) {
+            for (uint64_t bits = mask[word]; bits; bits &= bits - 1) fn(word * 64 + detail::lowestBit(bits));
+        }
+    }
+
+    /** @brief Lowest set index, or `count` if the mask is empty. */
+    inline size_t firstHit(const uint64_t* mask, size_t count) {
+        for (size_t word = 0; word < maskWords(count); ++word) {
+            if (mask[word]) return word * 64 + detail::lowestBit(mask[word]);
+        }
+        return count;
+    }
+}
+
+#endif // AABBBATCH_H
@@ -0,0 +1,74 @@
+#ifndef ABILITIES_H
+#define ABILITIES_H
+
+#include <SDL2/SDL.h>
+#include "Constants.h"
+#include "Structs.h"
+
+/**
+ * @brief Which sprite sheet a power uses.
+ */
+enum SpriteSet : Uint8 {
+    SPRITE_NORMAL,
+    SPRITE_DRAGON,
+    SPRITE_RHINO
+};
+
+/**
+ * @brief What the attack key does.
+ */
+enum AttackKind : Uint8 {
+    ATTACK_LUNGE,      ///< Short hop forward (no power)
+    ATTACK_PROJECTILE, ///< Fires a projectile of the power's type
+    ATTACK_CHARGE      ///< Dash at attackSpeed
+};
+
+/**
+ * @struct AbilityDef
+ * @brief Everything that makes one power behave differently.
+ *
+ * Gameplay code reads these fields instead of asking "which power is this?",
+ * so a new power is one more row in ABILITIES and one PowerType value.
+ */
+struct AbilityDef {
+    const char* name;            ///< For logs and debugging only
+    SpriteSet sprite;
+    AttackKind attack;
+    int attackCooldown;          ///< Ticks between attacks
+    float attackSpeed;           ///< Lunge / charge speed, or projectile speed
+    float maxSpeedMultiplier;    ///< Applied to MAX_VELOCITY_X
+    bool flies;                  ///< Jump levitates, glides while falling
+    bool absorbsHit;             ///< A hit breaks the power instead of costing HP
+    bool rams;                   ///< Body-collision rules of the rhino (counter / clash / charge damage)
+    float ramDamageMultiplier;   ///< Contact damage dealt while ramming
+    float healOnPickup;          ///< HP restored when collected
+    bool showIndicator;          ///< Draw the bar above the player's head
+    SDL_Color indicatorColor;
+};
+
+/**
+ * @brief The ability table, indexed by PowerType.
+ */
+constexpr AbilityDef ABILITIES[POWER_COUNT] = {
+    // POWER_NONE: basic lunge
+    {"none", SPRITE_NORMAL, ATTACK_LUNGE, 30, 3.0f,
+     1.0f, false, false, false, 1.0f, 0.0f, false, {0, 0, 0, 0}},
+    // POWER_FIRE: dragon, flies and shoots fireballs
+    {"fire", SPRITE_DRAGON, ATTACK_PROJECTILE, GameConstants::FIRE_COOLDOWN, GameConstants::PROJECTILE_SPEED,
+     1.0f, true, true, false, 1.0f, 0.0f, true, {255, 69, 0, 255}},
+    // POWER_SHIELD: rhino, faster, charges and rams
+    {"shield", SPRITE_RHINO, ATTACK_CHARGE, GameConstants::SPEED_COOLDOWN, GameConstants::SPEED_BOOST,
+     GameConstants::RHINO_SPEED_MULTIPLIER, false, true, true, GameConstants::RHINO_DAMAGE_MULTIPLIER, 0.0f, true, {0, 191, 255, 255}},
+    // POWER_HEALTH: heals on pickup, otherwise behaves like no power
+    {"health", SPRITE_NORMAL, ATTACK_LUNGE, 30, 3.0f,
+     1.0f, false, false, false, 1.0f, GameConstants::HEALTH_PICKUP, false, {0, 0, 0, 0}},
+};
+
+/**
+ * @brief Table row for a power (unknown values fall back to "none").
+ */
+constexpr const AbilityDef& ability(Uint8 power) {
+    return ABILITIES[power < POWER_COUNT ? power : static_cast<Uint8>(POWER_NONE)];
+}
+
+#endif // ABILITIES_H
@@ -0,0 +1,63 @@
+#ifndef BAKEDARENAS_H
+#define BAKEDARENAS_H
+
+#include <cstddef>
+#include <iterator>
+#include "LevelFormat.h"
+
+struct Platform;
+
+/**
+ * @namespace BakedArenas
+ * @brief Arenas whose platforms are compiled into the game, with collision
+ * code generated for each one.
+ *
+ * A baked arena's platform sweep is a template instantiated over its
+ * constexpr platform table: the loop is unrolled and every platform's edges
+ * are constants, so testing a platform the move doesn't come near costs a
+ * few compares against immediates. Results are identical to sweepPlatforms()
+ * on the same platforms (same candidates, same order, same tie rule).
+ *
+ * Level::attach() looks the loaded platforms up in the table, so both the
+ * built-in arena and a .lvl with the same platforms get the baked path.
+ * The tables are also kept in a level source (assets/levels/); this header
+ * needs no SDL so amphitude-levelc can refuse a source that drifted from them.
+ */
+namespace BakedArenas {
+    /** @brief The original six platforms (also the built-in arena, see Level::loadDefault()). */
+    inline constexpr LevelFormat::Rect CLASSIC[] = {
+        {0, 500, 800, 20},   // Ground
+        {150, 400, 150, 15}, // Left low
+        {500, 400, 150, 15}, // Right low
+        {325, 300, 150, 15}, // Middle high
+        {50, 250, 120, 15},  // Left high
+        {630, 250, 120, 15}  // Right high
+    };
+
+    /** @brief A baked arena's platforms, under the name its level source uses. */
+    struct Table {
+        const char* name;
+        const LevelFormat::Rect* platforms;
+        size_t platformCount;
+    };
+
+    /** @brief Every baked table. A level with one of these names must have exactly its platforms. */
+    inline constexpr Table TABLES[] = {
+        {"Classic", CLASSIC, std::size(CLASSIC)}
+    };
+
+    /** @brief Same contract as sweepPlatforms() (without the grid scratch). */
+    typedef float (*Sweep)(float x, float y, float w, float h, float dx, float dy, int& hit);
+
+    struct Arena {
+        const char* name;
+        const LevelFormat::Rect* platforms;
+        size_t platformCount;
+        Sweep sweep;
+    };
+
+    /** @brief The baked arena with exactly these platforms, or nullptr. */
+    const Arena* find(const Platform* platforms, size_t count);
+}
+
+#endif // BAKEDARENAS_H
@@ -0,0 +1,101 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "JobSystem.h"
+#include "WorldState.h"
+
+class Game;
+class Player;
+
+/**
+ * @class Bot
+ * @brief CPU opponent that drives one player's keys by searching ahead.
+ *
+ * Every few ticks the bot saves the world (Game::saveWorld) and runs a beam
+ * search on a private headless Game: each line is a few "moves" (keys held
+ * for a short while), replayed from the saved world with restoreWorld(), and
+ * scored on health, power and distance to the nearest opponent. Opponents are
+ * assumed to keep holding their current keys.
+ *
+ * The search has a hard time budget and plays the best first move found when
+ * it runs out, so a slow machine gets a weaker bot rather than a longer frame.
+ * With async on, the search runs as a background job on a worker thread; the
+ * bot keeps its previous move until the answer is in.
+ */
+class Bot {
+public:
+    enum Difficulty { EASY, NORMAL, HARD, DIFFICULTY_COUNT };
+
+    /** @brief Search settings for a difficulty. */
+    struct Config {
+        int depth;        ///< Moves per searched line
+        int beamWidth;    ///< Lines kept at each depth
+        int moveTicks;    ///< Ticks a move holds its keys
+        int replanTicks;  ///< Ticks between searches (reaction time)
+        int budgetMicros; ///< Time limit per search
+    };
+    static Config configFor(Difficulty difficulty);
+    static const char* difficultyName(Difficulty difficulty);
+
+    /**
+     * @param playerIndex Player the bot controls (index into Game's players).
+     * @param levelPath Arena of the match, nullptr for the built-in one.
+     * @param jobs Pool for async search, nullptr to always search inline.
+     */
+    Bot(int playerIndex, int numPlayers, Difficulty difficulty, const char* levelPath, JobSystem* jobs, bool async);
+    ~Bot();
+    Bot(const Bot&) = delete;
+    Bot& operator=(const Bot&) = delete;
+
+    /** @brief Sets the player's keys for the coming tick. Call right before Game::simulateTick(). */
+    void update(Game& game);
+
+    /** @brief Forgets the current plan (new match). Waits for a running search. */
+    void reset();
+
+    int playerIndex() const { return self; }
+    Difficulty difficulty() const { return chosenDifficulty; }
+    /** @brief Level file the sandbox was built from, empty for the built-in arena. */
+    const std::string& levelPath() const { return arenaPath; }
+
+private:
+    /** @brief A searched line: its first move (what we'd play now) and where it ended. */
+    struct Node {
+        int firstMove;
+        float score;
+        int state; ///< Index into `states`, -1 = the root
+    };
+
+    int self;
+    Difficulty chosenDifficulty;
+    std::string arenaPath;
+    Config config;
+    JobSystem* jobs;
+    bool async;
+    std::unique_ptr<Game> sandbox; ///< Headless copy the lines are played on
+
+    WorldState root;                 ///< World when the search started
+    std::vector<WorldState> states;  ///< End states of the lines (two generations)
+    std::vector<Node> parents, children;
+    JobGroup group;
+    bool searching = false;          ///< Background search in flight
+    int result = -1;                 ///< Move picked by the last search, -1 = none
+    int currentMove = 0;
+    int ticksToReplan = 0;
+
+    /** @brief Beam search from `root`; leaves the best first move in `result`. */
+    void search();
+
+    /** @brief Plays `move` for moveTicks on the sandbox and scores the outcome. */
+    float rollout(int move);
+
+    /** @brief How good the sandbox world looks for our player. */
+    float evaluate() const;
+
+    static void applyMove(Player& p, int move);
+};
+
+#endif // BOT_H
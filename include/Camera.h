@@ -0,0 +1,63 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include "Constants.h"
+#include "Utils.h"
+
+/**
+ * @struct Camera
+ * @brief The window's view into the arena.
+ *
+ * Arenas can be larger than the window. The camera centres on the players
+ * still in the match, eases towards them once per tick and never shows past
+ * the arena's edges; an arena no bigger than the window is shown whole and
+ * the camera stays put. Like the entities, it keeps last tick's position and
+ * is drawn interpolated (beginFrame()).
+ *
+ * Everything drawn in arena coordinates is shifted by (-viewX, -viewY), and
+ * sees() is the culling test against the view of the frame being drawn.
+ */
+struct Camera {
+    float x = 0, y = 0;         ///< Top-left of the view in the arena (this tick)
+    float prevX = 0, prevY = 0; ///< Last tick's, for interpolation
+    float viewX = 0, viewY = 0; ///< Top-left of the frame being drawn
+    float width = GameConstants::WINDOW_WIDTH;
+    float height = GameConstants::WINDOW_HEIGHT;
+
+    /** @brief Jumps straight to the target (match start). */
+    void snap(float targetX, float targetY, float arenaW, float arenaH) {
+        goal(targetX, targetY, arenaW, arenaH, x, y);
+        prevX = viewX = x;
+        prevY = viewY = y;
+    }
+
+    /** @brief Eases towards centring (targetX, targetY). Call once per tick. */
+    void follow(float targetX, float targetY, float arenaW, float arenaH) {
+        float gx, gy;
+        goal(targetX, targetY, arenaW, arenaH, gx, gy);
+        x += (gx - x) * 0.15f;
+        y += (gy - y) * 0.15f;
+    }
+
+    /** @brief Sets the view for this frame, part way between the last two ticks. */
+    void beginFrame(float alpha) {
+        viewX = lerp(prevX, x, alpha);
+        viewY = lerp(prevY, y, alpha);
+    }
+
+    /** @brief Whether a box (arena coordinates) is on screen, allowing `margin` pixels around it. */
+    bool sees(float bx, float by, float bw, float bh, float margin = 0) const {
+        return checkCollision(bx - margin, by - margin, bw + 2 * margin, bh + 2 * margin,
+                              viewX, viewY, width, height);
+    }
+
+private:
+    /** @brief View that centres the target without leaving the arena. */
+    void goal(float targetX, float targetY, float arenaW, float arenaH, float& gx, float& gy) const {
+        // An arena smaller than the view is centred on that axis
+        gx = arenaW <= width ? (arenaW - width) / 2 : clamp(targetX - width / 2, 0, arenaW - width);
+        gy = arenaH <= height ? (arenaH - height) / 2 : clamp(targetY - height / 2, 0, arenaH - height);
+    }
+};
+
+#endif // CAMERA_H
@@ -35,11 +35,23 @@ namespace GameConstants {
     const int WINDOW_WIDTH = 800;
     const int WINDOW_HEIGHT = 520;
     
-    /** @brief Target frames per second. */
+    /** @brief Frame cap used when vsync is off and the display rate is unknown. */
     const int TARGET_FPS = 60;
-    
-    /** @brief Milliseconds per frame (1000 / 60 = ~16ms). Used for frame capping. */
-    const int FRAME_DELAY = 1000 / TARGET_FPS;
+
+    // ==========================================
+    // Simulation Tick
+    // ==========================================
+    /**
+     * @brief Fixed simulation rate (ticks per second), independent of the display.
+     * Per-tick values below (velocities, frame timers) are tuned for 60.
+     */
+    const int TICK_RATE = 60;
+
+    /** @brief Longest stall the loop catches up on; anything beyond is dropped, not fast-forwarded. */
+    const int MAX_CATCHUP_MS = 250;
+
+    /** @brief Converts seconds to whole simulation ticks. */
+    constexpr int secondsToTicks(float seconds) { return static_cast<int>(seconds * TICK_RATE + 0.5f); }
 
     // ==========================================
     // Combat & Gameplay
@@ -52,15 +64,30 @@ namespace GameConstants {
     
     const float HEALTH_PICKUP = 30.0f;
     const float PROJECTILE_SPEED = 8.0f;
+    const float PROJECTILE_SIZE = 15.0f;
+    const float POWER_UP_SIZE = 25.0f;
     const float SPEED_BOOST = 20.0f;
     
     /** @brief Horizontal force applied when players collide. */
     const float KNOCKBACK_FORCE = 10.0f;
 
+    /** @brief Broadphase grid cell edge (about two player widths). */
+    const float BROADPHASE_CELL = 64.0f;
+
+    /** @brief Up to this many platforms a batch scan of all of them beats the grid. */
+    const int BATCH_SCAN_PLATFORMS = 128;
+
     // ==========================================
     // Timers (in frames)
     // ==========================================
     const float GAME_DURATION = 180.0f; // Seconds
+    const int GAME_DURATION_TICKS = secondsToTicks(GAME_DURATION);
+
+    /** @brief Lobby countdown once both players are ready (just under 4s so "3" shows at once). */
+    const int LOBBY_COUNTDOWN_TICKS = secondsToTicks(3.9f);
+
+    /** @brief Time on the pause screen before the match auto-ends. */
+    const int PAUSE_FORFEIT_TICKS = secondsToTicks(10.0f);
     const int FIRE_COOLDOWN = 30;
     const int SPEED_COOLDOWN = 60;
     
@@ -73,6 +100,7 @@ namespace GameConstants {
     
     /** @brief Interval between power-up spawns (milliseconds). */
     const int POWER_UP_SPAWN_INTERVAL = 10000; // 10 seconds
+    const int POWER_UP_SPAWN_TICKS = POWER_UP_SPAWN_INTERVAL * TICK_RATE / 1000;
     const float RHINO_SPEED_MULTIPLIER = 1.5f;
     const float RHINO_DAMAGE_MULTIPLIER = 2.0f;
 
@@ -80,6 +108,14 @@ namespace GameConstants {
 
     
     const int MAX_POWER_UPS = 3;
+    /** @brief Live projectiles at most; attacks beyond it don't fire. */
+    const int MAX_PROJECTILES = 128;
+
+    // ==========================================
+    // Match
+    // ==========================================
+    /** @brief Most players in one free-for-all (local: AMPHITUDE_PLAYERS). */
+    const int MAX_PLAYERS = 8;
 
     // ==========================================
     // Visual Effects
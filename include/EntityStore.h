@@ -0,0 +1,149 @@
+#ifndef ENTITYSTORE_H
+#define ENTITYSTORE_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+/**
+ * @class EntityStore
+ * @brief Structure-of-arrays storage for simple replicated entities
+ * (projectiles, power-ups). Particles have their own pool (ParticleSystem).
+ *
+ * Every attribute lives in its own tightly packed column, so the per-tick loops
+ * stream through exactly the floats they touch. Entity `i` is element `i` of
+ * every column; live entities are always `0 .. size()-1`.
+ *
+ * Removal is swap-and-pop: the last entity moves into the hole. Loops that
+ * remove while iterating must therefore re-visit index `i` instead of advancing.
+ * Indices are only good within a tick; across ticks and over the network an
+ * entity is identified by its netId.
+ */
+class EntityStore {
+public:
+    // Columns (all the same length)
+    std::vector<float> x, y;         ///< Position
+    std::vector<float> vx, vy;       ///< Velocity (pixels per tick)
+    std::vector<float> w, h;         ///< Size
+    std::vector<float> prevX, prevY; ///< Position before the last tick (render interpolation)
+    std::vector<int> life;           ///< Ticks left (power-ups)
+    std::vector<int> timer;          ///< Free-running per-entity counter (e.g. bobbing)
+    std::vector<Uint8> type;         ///< Kind of entity (PowerType for projectiles / power-ups)
+    std::vector<Sint8> owner;        ///< Player index that created it, -1 = nobody
+    std::vector<Uint16> netId;       ///< Stable network ID assigned by the host (0 = unassigned)
+    std::vector<SDL_Color> color;
+
+    /**
+     * @brief Fixed-capacity copy of every column: plain data, so it can live in
+     * a WorldState. N is a multiple of 4, which keeps the arrays free of padding.
+     */
+    template <int N>
+    struct Snapshot {
+        static_assert(N % 4 == 0, "Snapshot capacity must be a multiple of 4");
+        Uint32 count;
+        float x[N], y[N], vx[N], vy[N], w[N], h[N], prevX[N], prevY[N];
+        Sint32 life[N], timer[N];
+        Uint8 type[N];
+        Sint8 owner[N];
+        Uint16 netId[N];
+        SDL_Color color[N];
+    };
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    /** @brief Pre-sizes every column so adding up to `n` entities never allocates. */
+    void reserve(size_t n) {
+        x.reserve(n); y.reserve(n); vx.reserve(n); vy.reserve(n);
+        w.reserve(n); h.reserve(n); prevX.reserve(n); prevY.reserve(n);
+        life.reserve(n); timer.reserve(n); type.reserve(n); owner.reserve(n);
+        netId.reserve(n); color.reserve(n);
+    }
+
+    void clear() {
+        x.clear(); y.clear(); vx.clear(); vy.clear();
+        w.clear(); h.clear(); prevX.clear(); prevY.clear();
+        life.clear(); timer.clear(); type.clear(); owner.clear();
+        netId.clear(); color.clear();
+    }
+
+    /**
+     * @brief Appends an entity at rest; set the other columns through the returned index.
+     * @return Dense index of the new entity (valid until the next removal).
+     */
+    size_t add(float px, float py, float width, float height, Uint8 kind) {
+        x.push_back(px); y.push_back(py);
+        vx.push_back(0); vy.push_back(0);
+        w.push_back(width); h.push_back(height);
+        prevX.push_back(px); prevY.push_back(py);
+        life.push_back(0); timer.push_back(0);
+        type.push_back(kind); owner.push_back(-1);
+        netId.push_back(0);
+        color.push_back({255, 255, 255, 255});
+        return size() - 1;
+    }
+
+    /** @brief Removes entity `i` by moving the last entity into its place. */
+    void remove(size_t i) {
+        size_t last = size() - 1;
+        if (i != last) {
+            x[i] = x[last]; y[i] = y[last];
+            vx[i] = vx[last]; vy[i] = vy[last];
+            w[i] = w[last]; h[i] = h[last];
+            prevX[i] = prevX[last]; prevY[i] = prevY[last];
+            life[i] = life[last]; timer[i] = timer[last];
+            type[i] = type[last]; owner[i] = owner[last];
+            netId[i] = netId[last];
+            color[i] = color[last];
+        }
+
+        x.pop_back(); y.pop_back(); vx.pop_back(); vy.pop_back();
+        w.pop_back(); h.pop_back(); prevX.pop_back(); prevY.pop_back();
+        life.pop_back(); timer.pop_back(); type.pop_back(); owner.pop_back();
+        netId.pop_back(); color.pop_back();
+    }
+
+    /**
+     * @brief Copies the live entities into `out` (one memcpy per column).
+     * @return false (and `out` untouched) if there are more than N.
+     */
+    template <int N>
+    bool save(Snapshot<N>& out) const {
+        size_t n = size();
+        if (n > static_cast<size_t>(N)) return false;
+        out.count = static_cast<Uint32>(n);
+        if (n == 0) return true;
+        memcpy(out.x, x.data(), n * sizeof(float)); memcpy(out.y, y.data(), n * sizeof(float));
+        memcpy(out.vx, vx.data(), n * sizeof(float)); memcpy(out.vy, vy.data(), n * sizeof(float));
+        memcpy(out.w, w.data(), n * sizeof(float)); memcpy(out.h, h.data(), n * sizeof(float));
+        memcpy(out.prevX, prevX.data(), n * sizeof(float)); memcpy(out.prevY, prevY.data(), n * sizeof(float));
+        memcpy(out.life, life.data(), n * sizeof(int)); memcpy(out.timer, timer.data(), n * sizeof(int));
+        memcpy(out.type, type.data(), n); memcpy(out.owner, owner.data(), n);
+        memcpy(out.netId, netId.data(), n * sizeof(Uint16));
+        memcpy(out.color, color.data(), n * sizeof(SDL_Color));
+        return true;
+    }
+
+    /** @brief Replaces every entity with the contents of `in`. */
+    template <int N>
+    void restore(const Snapshot<N>& in) {
+        size_t n = in.count;
+        x.assign(in.x, in.x + n); y.assign(in.y, in.y + n);
+        vx.assign(in.vx, in.vx + n); vy.assign(in.vy, in.vy + n);
+        w.assign(in.w, in.w + n); h.assign(in.h, in.h + n);
+        prevX.assign(in.prevX, in.prevX + n); prevY.assign(in.prevY, in.prevY + n);
+        life.assign(in.life, in.life + n); timer.assign(in.timer, in.timer + n);
+        type.assign(in.type, in.type + n); owner.assign(in.owner, in.owner + n);
+        netId.assign(in.netId, in.netId + n);
+        color.assign(in.color, in.color + n);
+    }
+
+    /** @brief Copies positions into prevX/prevY (start of a tick). */
+    void storePrevious() {
+        prevX.assign(x.begin(), x.end());
+        prevY.assign(y.begin(), y.end());
+    }
+};
+
+#endif // ENTITYSTORE_H
@@ -0,0 +1,196 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "Constants.h"
+
+/**
+ * @class FramePacer
+ * @brief Decides when the next frame starts, using the high-resolution counter.
+ *
+ * Modes (picked with `AMPHITUDE_FPS=vsync|uncapped|<fps>`, default vsync):
+ * - Vsync: SDL_RenderPresent blocks on the display. The pacer only verifies
+ *   that it really does and falls back to a cap at the refresh rate if not.
+ * - Capped: frames start on a fixed schedule. The wait sleeps for the bulk of
+ *   the time and spins the last stretch, so deadlines are hit to within
+ *   microseconds instead of the 1 ms (and truncated 16 ms) of SDL_Delay.
+ * - Uncapped: no waiting at all (benchmarking).
+ *
+ * The wait happens at the start of a frame, right before input is read, so
+ * the time spent waiting never sits between input and display.
+ */
+class FramePacer {
+public:
+    enum Mode { MODE_VSYNC, MODE_CAPPED, MODE_UNCAPPED };
+
+    static const int HISTOGRAM_BUCKETS = 200;     ///< 0.25 ms each -> 0..50 ms
+    static const int BUCKETS_PER_MS = 4;
+
+    /**
+     * @brief Reads the requested mode from the environment. Call before creating
+     * the renderer, whose vsync flag depends on it (see wantsVsync()).
+     */
+    void configureFromEnvironment() {
+        const char* env = getenv("AMPHITUDE_FPS");
+        if (!env || !*env || strcmp(env, "vsync") == 0) {
+            mode = MODE_VSYNC;
+        } else if (strcmp(env, "uncapped") == 0 || strcmp(env, "0") == 0) {
+            mode = MODE_UNCAPPED;
+        } else {
+            int fps = atoi(env);
+            mode = MODE_CAPPED;
+            targetHz = fps > 0 ? fps : GameConstants::TARGET_FPS;
+        }
+    }
+
+    bool wantsVsync() const { return mode == MODE_VSYNC; }
+
+    /**
+     * @brief Starts pacing.
+     * @param rendererVsync Whether the renderer we actually got has PRESENTVSYNC.
+     * @param displayHz Refresh rate of the window's display (0 if unknown).
+     */
+    void start(bool rendererVsync, int displayHz) {
+        frequency = SDL_GetPerformanceFrequency();
+        refreshHz = displayHz > 0 ? displayHz : GameConstants::TARGET_FPS;
+        if (mode == MODE_VSYNC && !rendererVsync) {
+            std::cout << "Frame Pacer: Renderer has no vsync, capping at " << refreshHz << " Hz" << std::endl;
+            mode = MODE_CAPPED;
+            targetHz = refreshHz;
+        }
+        if (mode == MODE_CAPPED && targetHz <= 0) targetHz = refreshHz;
+
+        period = frequency / (mode == MODE_CAPPED ? targetHz : refreshHz);
+        spinWindow = frequency * SPIN_WINDOW_US / 1000000;
+        nextDeadline = SDL_GetPerformanceCounter() + period;
+        lastPresent = 0;
+        probeFrames = 0;
+        probeTime = 0;
+        memset(histogram, 0, sizeof(histogram));
+        frames = 0;
+        totalTime = 0;
+        worstTime = 0;
+
+        static const char* names[] = {"vsync", "capped", "uncapped"};
+        std::cout << "Frame Pacer: " << names[mode];
+        if (mode == MODE_CAPPED) std::cout << " at " << targetHz << " FPS";
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Blocks until the next frame should start (capped mode only).
+     */
+    void waitForNextFrame() {
+        if (mode != MODE_CAPPED) return;
+
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now < nextDeadline) {
+            // Coarse sleep while we're well ahead; SDL_Delay may overshoot by ~1 ms
+            Uint64 remaining = nextDeadline - now;
+            if (remaining > spinWindow) {
+                Uint32 sleepMs = static_cast<Uint32>((remaining - spinWindow) * 1000 / frequency);
+                if (sleepMs > 0) SDL_Delay(sleepMs);
+            }
+            // Precise finish
+            for (; SDL_GetPerformanceCounter() < nextDeadline; ) {}
+            nextDeadline += period;
+        } else {
+            // Missed the deadline: start the schedule over instead of rushing catch-up frames
+            nextDeadline = now + period;
+        }
+    }
+
+    /**
+     * @brief Call right after SDL_RenderPresent. Records the frame time and checks
+     * that vsync is really throttling us.
+     */
+    void framePresented() {
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (lastPresent != 0) {
+            Uint64 frameTime = now - lastPresent;
+            record(frameTime);
+            if (mode == MODE_VSYNC) verifyVsync(frameTime);
+        }
+        lastPresent = now;
+    }
+
+    /**
+     * @brief Prints average / percentile / worst frame times from the histogram.
+     */
+    void logStats() const {
+        if (frames == 0) return;
+        double avgMs = toMs(totalTime) / frames;
+        std::cout << "Frame Pacer: " << frames << " frames, avg " << avgMs << " ms ("
+                  << (avgMs > 0 ? 1000.0 / avgMs : 0) << " FPS), p50 " << percentileMs(0.50)
+                  << " ms, p99 " << percentileMs(0.99) << " ms, worst " << toMs(worstTime) << " ms" << std::endl;
+    }
+
+    Mode getMode() const { return mode; }
+
+private:
+    static const int SPIN_WINDOW_US = 2000; ///< Spin (don't sleep) for the last 2 ms
+    static const int VSYNC_PROBE_FRAMES = 120;
+
+    Mode mode = MODE_VSYNC;
+    int targetHz = 0;
+    int refreshHz = 60;
+    Uint64 frequency = 1;
+    Uint64 period = 0;
+    Uint64 spinWindow = 0;
+    Uint64 nextDeadline = 0;
+    Uint64 lastPresent = 0;
+
+    // Vsync Verification
+    int probeFrames = 0;
+    Uint64 probeTime = 0;
+
+    // Frame-Time Histogram
+    Uint32 histogram[HISTOGRAM_BUCKETS + 1]; ///< Last bucket = everything >= 50 ms
+    Uint32 frames = 0;
+    Uint64 totalTime = 0;
+    Uint64 worstTime = 0;
+
+    double toMs(Uint64 counts) const { return counts * 1000.0 / frequency; }
+
+    void record(Uint64 frameTime) {
+        int bucket = static_cast<int>(toMs(frameTime) * BUCKETS_PER_MS);
+        if (bucket > HISTOGRAM_BUCKETS) bucket = HISTOGRAM_BUCKETS;
+        histogram[bucket]++;
+        frames++;
+        totalTime += frameTime;
+        if (frameTime > worstTime) worstTime = frameTime;
+    }
+
+    double percentileMs(double p) const {
+        Uint32 target = static_cast<Uint32>(frames * p);
+        Uint32 seen = 0;
+        for (int i = 0; i <= HISTOGRAM_BUCKETS; ++i) {
+            seen += histogram[i];
+            if (seen > target) return static_cast<double>(i + 1) / BUCKETS_PER_MS; // Bucket upper edge
+        }
+        return static_cast<double>(HISTOGRAM_BUCKETS) / BUCKETS_PER_MS;
+    }
+
+    // Drivers can ignore the vsync request (forced off, some compositors, software
+    // renderer). If presents come in clearly faster than the refresh rate, cap instead.
+    void verifyVsync(Uint64 frameTime) {
+        if (probeFrames >= VSYNC_PROBE_FRAMES) return;
+        probeTime += frameTime;
+        if (++probeFrames < VSYNC_PROBE_FRAMES) return;
+
+        double measuredHz = probeFrames / (toMs(probeTime) / 1000.0);
+        if (measuredHz > refreshHz * 1.25) {
+            std::cout << "Frame Pacer: Vsync not in effect (" << static_cast<int>(measuredHz)
+                      << " FPS on a " << refreshHz << " Hz display), capping at " << refreshHz << " Hz" << std::endl;
+            mode = MODE_CAPPED;
+            targetHz = refreshHz;
+            period = frequency / targetHz;
+            nextDeadline = SDL_GetPerformanceCounter() + period;
+        }
+    }
+};
+
+#endif // FRAMEPACER_H
@@ -9,6 +9,16 @@
 #include "Player.h"
 #include "Structs.h"
 #include "NetworkManager.h"
+#include "FramePacer.h"
+#include "JobSystem.h"
+#include "WorldState.h"
+#include "AabbBatch.h"
+#include "ParticleSystem.h"
+#include "Bot.h"
+#include "Camera.h"
+#include "Random.h"
+
+struct PowerUpSpawn;
 
 /**
  * @class Game
@@ -35,11 +45,76 @@ public:
      */
     bool init();
 
+    /**
+     * @brief Copies the simulation state into `w` (a few microseconds).
+     * @return false if the world doesn't fit a WorldState (never in a normal match).
+     */
+    bool saveWorld(WorldState& w) const;
+
+    /**
+     * @brief Puts a saved simulation state back. The roster (names, sprites)
+     * is kept, so restore into the match the state was saved from.
+     */
+    void restoreWorld(const WorldState& w);
+
+    /**
+     * @brief Writes the current world to `amphitude-<reason>-<tick>.world`.
+     */
+    void dumpWorld(const char* reason) const;
+
+    // Headless simulation (amphitude-sim): no window, assets or network
+
+    /**
+     * @brief Prepares a local match without SDL.
+     * @param levelPath Compiled level, nullptr for the built-in arena.
+     * @return false if the level can't be loaded.
+     */
+    bool initHeadless(int numPlayers, const char* levelPath);
+
+    /** @brief Starts a fresh local match; the same seed plays out the same way for the same inputs. */
+    void startMatch(Uint32 seed);
+
+    /** @brief Advances the match one tick (what update() runs while PLAYING). */
+    void simulateTick();
+
+    // Online snapshots without a socket (amphitude-loopback plays both peers)
+
+    /**
+     * @brief Starts a headless match as one side of an online session: the host
+     * simulates with authority, the client predicts P2 and applies snapshots.
+     */
+    void startOnlineMatch(Uint32 seed, bool host);
+
+    /** @brief Host: the state after the last tick as a snapshot (no events or checksums yet). */
+    void writeSnapshot(Packet& s) const;
+
+    /** @brief Host: adds the pending events and our checksum report to a snapshot that goes out. */
+    void finishSnapshot(Packet& s);
+
+    /**
+     * @brief Client: applies a host snapshot, digests the rebuilt world under the
+     * host's tick and compares it with the host's report.
+     * @return false if the report shows a desync.
+     */
+    bool applySnapshot(const Packet& s);
+
+    bool matchRunning() const { return currentState == PLAYING; }
+    int getWinnerId() const { return winnerId; }
+    Uint32 getSimTick() const { return simTick; }
+    /** @brief Players of the current match; set their key flags before each tick. */
+    std::vector<Player>& getPlayers() { return players; }
+    const std::vector<Player>& getPlayers() const { return players; }
+    const EntityStore& getPowerUps() const { return powerUps; }
+    const EntityStore& getProjectiles() const { return projectiles; }
+    const Level& getLevel() const { return level; }
+
     /**
      * @brief Starts the main game loop.
      * 
      * This loop runs until the user closes the window.
-     * It enforces a fixed frame rate (60 FPS).
+     * The simulation advances in fixed ticks (GameConstants::TICK_RATE),
+     * zero or more per frame; rendering runs at the display rate and
+     * interpolates between the last two ticks.
      */
     void run();
 
@@ -51,7 +126,7 @@ private:
     bool inputtingP1;
     bool p1Ready;
     bool p2Ready;
-    float lobbyStartTimer;
+    int lobbyStartTicks; ///< Countdown to match start (ticks, -1 = not counting)
     bool countingDown;
     std::string p1NameInput;
     std::string p2NameInput;
@@ -102,7 +177,10 @@ private:
 
     // Name Input
     std::string inputText;
-    int winnerId = 0; // 0 = None/Draw, 1 = P1, 2 = P2
+    int winnerId = 0; // 0 = None/Draw, otherwise the winner's player ID
+    int localPlayers = 2; // Players in a local match (AMPHITUDE_PLAYERS)
+    bool vsCpu = false;   // Local match where everyone but P1 is a Bot
+    Bot::Difficulty botDifficulty = Bot::NORMAL;
     int ignoreInputFrames = 0; // To prevent immediate key capture
     
     // Signaling State
@@ -112,25 +190,209 @@ private:
     bool enteringCode = false; // For Join menu
 
 
-    // Timer
-    float gameTime;
-    float pauseTime;
+    // Timers (all in simulation ticks)
+    int gameTicks;          ///< Match time remaining
+    int pauseTicks;         ///< Pause screen time left before auto-forfeit
+    int powerUpSpawnTicks;  ///< Until the next power-up spawn
+
+    // Frame Pacing (vsync / precise cap / uncapped, see FramePacer)
+    FramePacer pacer;
+
+    // Worker threads for parallel stages (particles, projectile sweeps, asset decoding)
+    JobSystem jobs;
 
-    Uint32 lastPowerUpTime;
+    // Fixed Timestep: how far render() is between the last two ticks (0..1)
+    float renderAlpha = 1.0f;
+
+    /**
+     * @brief Remembers where everything was before this tick, for render interpolation.
+     */
+    void storePreviousPositions();
+
+    /** @brief Points the camera at the players still in the match (snap = no easing). */
+    void followCamera(bool snap);
 
     // Game Objects
-    std::vector<Player> players;
-    std::vector<Platform> platforms;
-    std::vector<Projectile> projectiles;
-    std::vector<PowerUp> powerUps;
-    std::vector<Particle> particles;
+    std::vector<Player> players; ///< Index = ID - 1; P2 is the online peer
+    Level level;
+    std::string levelFile;       ///< Arena file in use, empty = built-in (bots load their own copy)
+    std::vector<std::unique_ptr<Bot>> bots; ///< CPU players (after `jobs`: their searches finish first)
+    EntityStore projectiles;
+    // Player boxes as packed columns for the batch overlap kernels, refreshed every
+    // tick (knocked-out players and unused slots sit at AabbBatch::FAR)
+    static const size_t PLAYER_LANES = AabbBatch::paddedCount(GameConstants::MAX_PLAYERS);
+    float playerBoxX[PLAYER_LANES], playerBoxY[PLAYER_LANES];
+    float playerBoxW[PLAYER_LANES], playerBoxH[PLAYER_LANES];
+    EntityStore powerUps;
+    ParticleSystem particles;
+    Camera camera; ///< Render-side only: not part of the world state
+
+    // Match Randomness (seeded per match; online, the host's seed comes with the start packet)
+    Uint32 matchSeed = 0;
+    Uint32 fixedSeed = 0;      ///< AMPHITUDE_SEED: seed every local match with this (0 = fresh each match)
+    Random gameplayRng;        ///< Simulation outcomes, drawn identically by both peers
+    Random cosmeticRng;        ///< Effect seeds
+    Uint32 powerUpSpawns = 0;  ///< Power-ups rolled this match; a power-up's network ID is its spawn number
+
+    // Gameplay Events (effects are spawned from events, never directly by the simulation)
+    Uint32 simTick = 0;                   ///< PLAYING updates since the match started
+    std::vector<GameEvent> frameEvents;   ///< Emitted by this frame's simulation
+    /** @brief Host: event waiting to be (re)sent to the client. */
+    struct OutgoingEvent {
+        GameEvent event;
+        Uint8 timesSent;
+    };
+    std::vector<OutgoingEvent> outgoingEvents;
+    Uint16 nextEventSeq = 0;  ///< Host: last assigned sequence number
+    Uint16 lastEventSeq = 0;  ///< Client: newest sequence number already played
     std::map<std::string, SDL_Texture*> textCache;
 
+    // Client-Side Prediction (Client runs its own player locally, host stays authoritative)
+    /** @brief Local input and the state it predicted, stored per input tick. */
+    struct PredictedFrame {
+        Uint32 tick;
+        Uint8 input;        ///< Packed keys (Player::getInputBits)
+        float x, y, vx, vy; ///< Predicted state after applying this input
+        bool onGround;
+    };
+    static const int INPUT_HISTORY_SIZE = 128; ///< ~2s at 60 FPS, far above any sane RTT
+    PredictedFrame inputHistory[INPUT_HISTORY_SIZE];
+    Uint32 localInputTick = 0;     ///< Client: tick of the newest sampled input
+    Uint32 lastAckedInputTick = 0; ///< Client: newest tick the host has confirmed
+    EntityStore scratchProjectiles; ///< Discarded output of replayed updates
+
+    /** @brief Where one projectile's move ends this tick (see sweepProjectile()). */
+    struct ProjectileHit {
+        float time;  ///< Fraction of the move travelled (0..1)
+        int wall;    ///< Platform hit, -1 = none
+        int target;  ///< Player index hit, -1 = none
+    };
+    std::vector<ProjectileHit> projectileHits; ///< Per projectile, this tick
+    std::vector<Uint16> sweepScratch;     ///< Platform grid queries of the in-order re-sweeps
+    std::vector<Uint16> visiblePlatforms; ///< Render: platforms in view this frame
+    bool worldDumped = false; ///< A desync dump was already written this match
+    bool headless = false;    ///< amphitude-sim: no SDL, no effects
+
+    /**
+     * @brief Sweeps projectile `i` against the platforms and players without
+     * changing anything (safe to call from several threads at once).
+     */
+    void sweepProjectile(size_t i, std::vector<Uint16>& scratch, ProjectileHit& hit) const;
+
+    /** @brief Copies player `i`'s box into the packed columns. */
+    void packPlayerBox(size_t i);
+    AabbBatch::Boxes playerBoxes() const {
+        return {playerBoxX, playerBoxY, playerBoxW, playerBoxH, PLAYER_LANES};
+    }
+    std::vector<GameEvent> scratchEvents;
+
+    // Desync Detection (both peers checksum every tick they simulate)
+    DesyncDetector desync;
+
+    /**
+     * @brief Checksums the simulation-relevant world state for `tick`.
+     *
+     * Online, Player 2 is left out: the client predicts it ahead of the host and
+     * reconcileLocalPlayer() already corrects it.
+     */
+    void captureDigest(WorldDigest& d, Uint32 tick) const;
+
+    // Host Input Buffer (Client inputs queued by tick, consumed one per frame)
+    Uint8 remoteInputs[INPUT_HISTORY_SIZE];
+    Uint32 remoteInputTicks[INPUT_HISTORY_SIZE];
+    Uint32 remoteInputNewest = 0;  ///< Host: newest client tick received
+    Uint32 remoteInputApplied = 0; ///< Host: last client tick applied to the simulation
+
     // Internal Methods
     void loadAssets();
     void initGameObjects();
+    /** @brief Sizes the per-match storage for the loaded level (shared with headless mode). */
+    void initSimulation();
     void resetGame();
+    /** @brief Host / local: rolls a power-up from the gameplay stream if there is room. */
     void spawnPowerUps();
+    /** @brief Adds spawn number `powerUpSpawns` to the arena. */
+    void addPowerUp(const PowerUpSpawn& spawn);
+
+    /**
+     * @brief Client: replays the host's newer spawns from the shared stream and
+     * keeps exactly the power-ups the snapshot still lists.
+     */
+    void syncPowerUps(const Packet& hostState);
+
+    /**
+     * @brief Whether the peer plays the same arena file. If not, leaves the
+     * online session (back to the menu, with the reason shown).
+     */
+    bool samePeerLevel(const Packet& p);
+
+    // Replicated Entity IDs
+    Uint16 nextNetId = 0;
+    Uint16 allocNetId();
+
+    /**
+     * @brief Gives every new projectile / power-up a stable network ID (host or local only).
+     */
+    void assignNetIds();
+
+    /**
+     * @brief Whether this machine's keyboard drives player `i`. Online only our
+     * own player does (host P1, client P2); the peer's comes from the network.
+     */
+    bool isLocalPlayer(size_t i) const;
+
+    /**
+     * @brief Host: queues the (redundant) inputs carried by a client input packet.
+     */
+    void queueRemoteInput(const Packet& p);
+
+    /**
+     * @brief Host: applies the next queued client input to Player 2.
+     */
+    void applyNextRemoteInput();
+
+    /**
+     * @brief Client: rewinds Player 2 to the host's state for the acknowledged
+     * input tick and replays all newer local inputs on top of it.
+     */
+    void reconcileLocalPlayer(const Packet& hostState);
+
+    /**
+     * @brief Bumps, rams and clashes between two overlapping players.
+     */
+    void resolvePlayerCollision(Player& a, Player& b);
+
+    /** @brief Players with HP left. */
+    int alivePlayers() const;
+
+    /**
+     * @brief The last player standing, or on time out the one with the most HP.
+     * @return Player ID, 0 for a draw.
+     */
+    int decideWinner() const;
+
+    /**
+     * @brief Stamps, plays and (host) queues the events emitted this frame.
+     *
+     * The client discards its own simulated events and only plays the host's,
+     * so both screens show the same effects.
+     */
+    void processEvents();
+
+    /**
+     * @brief Spawns the cosmetic effect for an event (deterministic from its seed).
+     */
+    void playEvent(const GameEvent& e);
+
+    /**
+     * @brief Host: fills the packet's event section from the outgoing queue.
+     */
+    void writeEvents(Packet& p);
+
+    /**
+     * @brief Client: plays the events in a host packet that weren't seen yet.
+     */
+    void readEvents(const Packet& p);
     void handleEvents(SDL_Event& event);
     void update();
     void render();
@@ -0,0 +1,242 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class JobGroup
+ * @brief Counts the unfinished jobs of one stage. JobSystem::wait() joins it.
+ */
+class JobGroup {
+public:
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> pending{0};
+};
+
+/**
+ * @class JobSystem
+ * @brief Small work-stealing thread pool.
+ *
+ * Every thread in the pool owns a job queue: the workers, plus the thread that
+ * called start() as slot 0. A thread pushes and pops its own queue at the back
+ * (newest, cache-warm job first); when it runs dry it steals the oldest job from
+ * another queue. Jobs are added to a JobGroup and wait() joins the group. The
+ * waiting thread runs jobs itself until the group is done, so stages can wait
+ * on sub-stages from inside a job (a task graph) without deadlocking, and the
+ * caller's core is never idle during a join while there is work. When there is
+ * none left for it, it spins briefly and then sleeps until the group finishes
+ * or a job it could run is queued.
+ *
+ * Long jobs that must not hold up a frame (bot search) go in with
+ * runBackground(): only an idle worker takes them, never a thread helping in wait().
+ *
+ * With no workers (or before start()) run() executes jobs inline, so callers
+ * don't need a serial fallback. Results must not depend on which thread ran a
+ * job: the simulation stays deterministic however many cores there are.
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    JobSystem() = default;
+    ~JobSystem() { stop(); }
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Starts the worker threads. Call from the thread that will wait on jobs.
+     * @param workers Extra threads; -1 = one per remaining core, 0 = run everything inline.
+     */
+    void start(int workers = -1) {
+        stop();
+        if (workers < 0) {
+            unsigned cores = std::thread::hardware_concurrency();
+            workers = cores > 1 ? static_cast<int>(cores) - 1 : 0;
+        }
+        quit = false;
+        queues.clear();
+        queued = 0;
+        foreground = 0;
+        for (int i = 0; i <= workers; ++i) queues.emplace_back(new Queue());
+        currentSlot() = 0;
+        for (int i = 1; i <= workers; ++i) threads.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    /** @brief Joins the workers (call between stages: queued jobs are not run). */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+        threads.clear();
+    }
+
+    int workerCount() const { return static_cast<int>(threads.size()); }
+
+    /** @brief Queues a job in `group` (runs it right away if there are no workers). */
+    void run(JobGroup& group, Job job) { push(group, std::move(job), false); }
+
+    /**
+     * @brief Queues a job for an idle worker. wait() never runs it on the
+     * waiting thread, so a long job can't end up inside a frame-critical join.
+     */
+    void runBackground(JobGroup& group, Job job) { push(group, std::move(job), true); }
+
+    /** @brief Returns once every job in `group` has finished, running jobs meanwhile. */
+    void wait(JobGroup& group) {
+        int self = ownSlot();
+        for (int spins = 0; !group.done(); ) {
+            if (runOne(self, false)) {
+                spins = 0;
+                continue;
+            }
+            // The last jobs are running elsewhere; they are usually short, so spin a little first
+            if (++spins < WAIT_SPINS) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            waiting++;
+            joined.wait(lock, [&] { return group.done() || foreground.load(std::memory_order_acquire) > 0; });
+            waiting--;
+            spins = 0;
+        }
+    }
+
+    /**
+     * @brief Calls fn(begin, end) over consecutive chunks of [first, last) in
+     * parallel and returns when all are done. The caller runs the last chunk.
+     * @param grain Items per chunk; ranges no larger than this run inline.
+     */
+    template <typename Fn>
+    void parallelFor(int first, int last, int grain, Fn fn) {
+        if (last - first <= grain || threads.empty()) {
+            if (first < last) fn(first, last);
+            return;
+        }
+        JobGroup group;
+        int begin = first;
+        for (; last - begin > grain; begin += grain) {
+            int end = begin + grain;
+            run(group, [&fn, begin, end] { fn(begin, end); });
+        }
+        fn(begin, last);
+        wait(group);
+    }
+
+private:
+    struct Entry {
+        Job job;
+        JobGroup* group;
+        bool background; ///< Only taken by idle workers
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Entry> jobs;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues; ///< One per slot (0 = the owning thread)
+    std::vector<std::thread> threads;
+    std::atomic<int> queued{0};                 ///< Jobs waiting in any queue
+    std::atomic<int> foreground{0};             ///< ...of which wait() may run
+    std::mutex sleepMutex;
+    std::condition_variable wake;               ///< Idle workers
+    std::condition_variable joined;             ///< Threads sleeping in wait()
+    int waiting = 0;                            ///< Sleepers in wait() (under sleepMutex)
+    bool quit = false;
+    static const int WAIT_SPINS = 64;           ///< Empty polls in wait() before sleeping
+
+    void push(JobGroup& group, Job job, bool background) {
+        if (threads.empty()) {
+            job();
+            return;
+        }
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+        Queue& q = *queues[ownSlot()];
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.jobs.push_back({std::move(job), &group, background});
+        }
+        if (!background) foreground.fetch_add(1, std::memory_order_release);
+        queued.fetch_add(1, std::memory_order_release);
+        bool helpers;
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex); // Don't slip between a sleeper's check and its sleep
+            helpers = !background && waiting > 0;
+        }
+        wake.notify_one();
+        if (helpers) joined.notify_all();
+    }
+
+    /** @brief This thread's queue index (-1 outside the pool). */
+    static int& currentSlot() {
+        thread_local int slot = -1;
+        return slot;
+    }
+
+    /** @brief Threads outside the pool share the owner's queue. */
+    int ownSlot() const {
+        int s = currentSlot();
+        return (s < 0 || s >= static_cast<int>(queues.size())) ? 0 : s;
+    }
+
+    /** @brief Runs one job: our newest, else another queue's oldest. */
+    bool runOne(int self, bool takeBackground) {
+        Entry e;
+        if (!pop(self, takeBackground, e)) return false;
+        e.job();
+        if (e.group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+            }
+            joined.notify_all();
+        }
+        return true;
+    }
+
+    bool pop(int self, bool takeBackground, Entry& out) {
+        if (queued.load(std::memory_order_acquire) == 0) return false;
+        int n = static_cast<int>(queues.size());
+        for (int k = 0; k < n; ++k) {
+            Queue& q = *queues[(self + k) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            // Own queue from the back, others from the front, skipping background jobs if asked
+            size_t count = q.jobs.size();
+            for (size_t j = 0; j < count; ++j) {
+                size_t at = k == 0 ? count - 1 - j : j;
+                if (q.jobs[at].background && !takeBackground) continue;
+                out = std::move(q.jobs[at]);
+                q.jobs.erase(q.jobs.begin() + at);
+                if (!out.background) foreground.fetch_sub(1, std::memory_order_relaxed);
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int slot) {
+        currentSlot() = slot;
+        for (;;) {
+            if (runOne(slot, true)) continue;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] { return quit || queued.load(std::memory_order_acquire) > 0; });
+            if (quit) return;
+        }
+    }
+};
+
+#endif // JOBSYSTEM_H
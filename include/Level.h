@@ -0,0 +1,98 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Structs.h"
+#include "SpatialGrid.h"
+#include "AabbBatch.h"
+#include "BakedArenas.h"
+#include "LevelFormat.h"
+
+/**
+ * @class Level
+ * @brief A loaded arena: platforms, tile layers, spawn points and power-up zones.
+ *
+ * The file is memory-mapped (read into memory on Windows) and its arrays are
+ * used in place, without parsing. Loading validates the header and builds the
+ * derived tables the game needs every tick: the static collision grid and the
+ * packed (SoA) columns over the platforms, and the cumulative weights for
+ * picking power-up zones.
+ */
+class Level {
+public:
+    Level() = default;
+    ~Level() { unload(); }
+    Level(const Level&) = delete;
+    Level& operator=(const Level&) = delete;
+
+    /**
+     * @brief Maps and validates a compiled level file.
+     * @return false (and nothing loaded) if the file is missing or malformed.
+     */
+    bool load(const char* path);
+
+    /** @brief Loads the built-in arena (the original six platforms). */
+    void loadDefault();
+
+    const char* name() const { return header->name; }
+    float width() const { return header->width; }
+    float height() const { return header->height; }
+    Uint32 checksum() const { return header->checksum; }
+
+    int platformCount() const { return static_cast<int>(header->platformCount); }
+    /** @brief Platforms, straight from the file. */
+    const Platform* platforms() const { return platformData; }
+    LevelFormat::TileLayer tileLayer(int i) const {
+        return static_cast<LevelFormat::TileLayer>(layerData[i]);
+    }
+
+    /** @brief Broadphase over platforms() (IDs are platform indices). */
+    const SpatialGrid& collisionGrid() const { return grid; }
+
+    /** @brief Compiled-in collision code for these platforms, nullptr if not a baked arena. */
+    const BakedArenas::Arena* bakedArena() const { return baked; }
+
+    /** @brief platforms() as packed columns for AabbBatch (padded; bit i = platform i). */
+    AabbBatch::Boxes platformBoxes() const {
+        return {boxX.data(), boxY.data(), boxW.data(), boxH.data(), boxX.size()};
+    }
+
+    /**
+     * @brief Spawn point for a player.
+     * @return false if the level has none of that kind for the player.
+     */
+    bool spawnPoint(int player, LevelFormat::SpawnKind kind, float& x, float& y) const;
+
+    bool hasPowerUpZones() const { return zoneTotal > 0; }
+    /**
+     * @brief Picks a power-up zone by weight.
+     * @param random Any random number (e.g. Random::next()).
+     */
+    const LevelFormat::Zone& pickPowerUpZone(Uint32 random) const;
+
+private:
+    const LevelFormat::Header* header = nullptr;
+    const Platform* platformData = nullptr;
+    const Uint8* layerData = nullptr;
+    const LevelFormat::Spawn* spawnData = nullptr;
+    const LevelFormat::Zone* zoneData = nullptr;
+
+    // Backing storage: either a mapping or an owned buffer
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    std::vector<Uint8> owned;
+
+    // Derived at load time
+    SpatialGrid grid;
+    std::vector<float> boxX, boxY, boxW, boxH; ///< Platform columns, padded with far boxes
+    const BakedArenas::Arena* baked = nullptr;
+    std::vector<Uint32> zoneCumulative; ///< Running sum of zone weights
+    Uint32 zoneTotal = 0;
+
+    void unload();
+    /** @brief Validates the image and points the accessors into it. */
+    bool attach(const Uint8* data, size_t size, const char* source);
+};
+
+#endif // LEVEL_H
@@ -0,0 +1,143 @@
+#ifndef LEVELFORMAT_H
+#define LEVELFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace LevelFormat
+ * @brief Binary arena format shared by the game and the `amphitude-levelc` compiler.
+ *
+ * A level file is a fixed header followed by flat, 4-byte aligned arrays that
+ * are used in place: the game maps the file and points straight into it, so
+ * loading is a validation pass plus building the collision grid and spawn
+ * tables. Everything is little-endian (all supported targets are).
+ *
+ * Layout: Header | platforms (Rect[]) | tile layers (uint8_t[], padded) |
+ * spawns (Spawn[]) | power-up zones (Zone[])
+ */
+namespace LevelFormat {
+    /** @brief "ALVL" - marks a level file. */
+    const char MAGIC[4] = {'A', 'L', 'V', 'L'};
+    const uint16_t VERSION = 1;
+
+    /** @brief Upper bound per section (broadphase IDs are 16-bit). */
+    const uint32_t MAX_ITEMS = 4096;
+
+    /** @brief How a platform is drawn. */
+    enum TileLayer : uint8_t {
+        LAYER_GROUND = 0, ///< Tiled with the season's ground texture
+        LAYER_GLASS  = 1  ///< Translucent glass slab
+    };
+
+    /** @brief What a spawn point is used for. */
+    enum SpawnKind : uint8_t {
+        SPAWN_START   = 0, ///< Where the player starts a match
+        SPAWN_RESPAWN = 1  ///< Where the player reappears after falling off
+    };
+
+    struct Header {
+        char magic[4];
+        uint16_t version;
+        uint16_t headerSize;     ///< sizeof(Header), for forward compatibility checks
+        uint32_t fileSize;       ///< Whole file, header included
+        uint32_t checksum;       ///< FNV-1a of everything after the header
+        float width, height;     ///< Arena size in pixels
+        char name[32];           ///< Display name, NUL-terminated
+        uint32_t platformCount, platformOffset;
+        uint32_t layerOffset;    ///< One TileLayer byte per platform
+        uint32_t spawnCount, spawnOffset;
+        uint32_t zoneCount, zoneOffset;
+    };
+
+    /** @brief Solid platform. Same layout as the game's Platform struct. */
+    struct Rect {
+        float x, y, w, h;
+    };
+
+    struct Spawn {
+        float x, y;
+        uint8_t player;      ///< Player index (0-based)
+        uint8_t kind;        ///< SpawnKind
+        uint8_t reserved[2];
+    };
+
+    /**
+     * @brief Strip where power-ups appear: the crate's left edge is placed
+     * anywhere in [x, x + w] with its top at y. Zones are picked by weight.
+     */
+    struct Zone {
+        float x, y, w;
+        uint32_t weight;
+    };
+
+    static_assert(sizeof(Header) == 84, "Level header layout changed");
+    static_assert(sizeof(Rect) == 16 && sizeof(Spawn) == 12 && sizeof(Zone) == 16,
+                  "Level record layout changed");
+
+    inline uint32_t checksum(const uint8_t* data, size_t len) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < len; ++i) {
+            h ^= data[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    inline uint32_t align4(uint32_t n) { return (n + 3u) & ~3u; }
+
+    /**
+     * @struct Builder
+     * @brief Collects a level's contents and lays them out as a file image.
+     */
+    struct Builder {
+        std::string name;
+        float width = 0, height = 0;
+        std::vector<Rect> platforms;
+        std::vector<uint8_t> layers; ///< Parallel to platforms
+        std::vector<Spawn> spawns;
+        std::vector<Zone> zones;
+
+        std::vector<uint8_t> build() const {
+            Header h;
+            memset(&h, 0, sizeof(h));
+            memcpy(h.magic, MAGIC, 4);
+            h.version = VERSION;
+            h.headerSize = sizeof(Header);
+            h.width = width;
+            h.height = height;
+            strncpy(h.name, name.c_str(), sizeof(h.name) - 1);
+
+            uint32_t offset = sizeof(Header);
+            h.platformCount = static_cast<uint32_t>(platforms.size());
+            h.platformOffset = offset;
+            offset += h.platformCount * sizeof(Rect);
+            h.layerOffset = offset;
+            offset = align4(offset + h.platformCount);
+            h.spawnCount = static_cast<uint32_t>(spawns.size());
+            h.spawnOffset = offset;
+            offset += h.spawnCount * sizeof(Spawn);
+            h.zoneCount = static_cast<uint32_t>(zones.size());
+            h.zoneOffset = offset;
+            offset += h.zoneCount * sizeof(Zone);
+            h.fileSize = offset;
+
+            std::vector<uint8_t> out(offset, 0);
+            if (!platforms.empty()) memcpy(&out[h.platformOffset], platforms.data(), platforms.size() * sizeof(Rect));
+            for (size_t i = 0; i < platforms.size(); ++i) {
+                out[h.layerOffset + i] = i < layers.size() ? layers[i] : static_cast<uint8_t>(LAYER_GLASS);
+            }
+            if (!spawns.empty()) memcpy(&out[h.spawnOffset], spawns.data(), spawns.size() * sizeof(Spawn));
+            if (!zones.empty()) memcpy(&out[h.zoneOffset], zones.data(), zones.size() * sizeof(Zone));
+
+            h.checksum = checksum(out.data() + sizeof(Header), out.size() - sizeof(Header));
+            memcpy(out.data(), &h, sizeof(h));
+            return out;
+        }
+    };
+}
+
+#endif // LEVELFORMAT_H
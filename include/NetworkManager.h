@@ -1,65 +1,133 @@
 #ifndef NETWORKMANAGER_H
 #define NETWORKMANAGER_H
 #include <SDL2/SDL_net.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
 #include "StunClient.h"
+#include "ShmTransport.h"
+#include "RelayProtocol.h"
+#include "Constants.h"
+#include "Structs.h"
+#include "WorldChecksum.h"
 
 // ... (Struct definitions Packet, NetPowerUp remain same) ...
 // Except we need to make Packet serializable or just use it as is if it's POD.
 // It is POD.
 
+// Power-ups are rolled from the shared gameplay stream on both peers, so a
+// snapshot only says which ones are still there and for how long
 struct NetPowerUp {
-    float x, y;
-    char type[20];
+    Uint16 id; // Spawn number (matches EntityStore::netId)
+    Uint16 lifetime;
 };
 
+/**
+ * @struct NetPlayer
+ * @brief Replicated state of one player in a snapshot (28 bytes).
+ */
+struct NetPlayer {
+    float x, y, vx, vy;
+    Sint16 hp;
+    Sint16 powerTimer;
+    Sint16 invincible;
+    Sint16 attackCooldown;
+    Uint8 power;  // PowerType
+    Uint8 flags;  // FLAG_FACING_LEFT | FLAG_ON_GROUND
+    Uint8 reserved[2];
+
+    enum : Uint8 { FLAG_FACING_LEFT = 1, FLAG_ON_GROUND = 2 };
+};
+static_assert(sizeof(NetPlayer) == 28, "NetPlayer is sent on the wire");
+
 struct Packet {
     Uint32 seqId; // For reliability (Simple ACK)
     int type; // 0=Handshake, 1=Input, 2=State, 3=Start, 4=Ping/Punch
     
     // Input Data
-    bool keys[5]; // Left, Right, Jump, Down, Attack
+    Uint32 inputTick; // Client: tick number of the newest input (increments every frame)
+    Uint8 inputHistory[8]; // Client: packed keys (Left, Right, Jump, Down, Attack) for inputTick, inputTick-1, ...
+                           // Older ticks are repeated so a lost packet doesn't lose input
+    Uint32 ackInputTick; // Host: last client input tick applied to this state (for reconciliation)
     
     // State Data (Host -> Client)
-    float gameTime;
-    
-    float p1X, p1Y, p1VX, p1VY;
-    int p1HP;
-    char p1Power[20];
-    int p1PowerTimer;
-    int p1Invincible;
-    int p1AttackCooldown;
-    bool p1FacingLeft;
-    
-    float p2X, p2Y, p2VX, p2VY;
-    int p2HP;
-    char p2Power[20];
-    int p2PowerTimer;
-    int p2Invincible;
-    int p2AttackCooldown;
-    bool p2FacingLeft;
-    
+    int gameTicks; // Match time remaining (ticks)
+    Uint32 hostTick; // Host: simTick whose state this snapshot carries
+    Uint32 matchSeed; // Host: seeds the match's random streams (start packet and snapshots)
+    Uint32 powerUpSpawns; // Host: power-ups spawned so far this match
+    Uint32 levelChecksum; // Lobby, start packet and snapshots: the sender's arena (Level::checksum)
+
     int numPowerUps;
     NetPowerUp powerUps[5];
     
     int numProjectiles;
     struct NetProjectile {
+        Uint16 id; // Stable network ID (matches EntityStore::netId)
         float x, y, vx, vy;
-        int owner; // 0 or 1
-        char type[10];
+        int owner; // Player index
+        Uint8 type; // PowerType that fired it
     } projectiles[10];
-    
+
+    // Gameplay Events (Host -> Client). Each event is repeated in a few packets;
+    // the client drops duplicates by GameEvent::seq.
+    Uint8 numEvents;
+    GameEvent events[8];
+
     int gameState; // 0=Menu, 1=Name, 2=Playing, 3=Paused, 4=GameOver
-    int winnerId; // 0=None, 1=P1, 2=P2
+    int winnerId; // 0=None/Draw, otherwise the winner's player ID (1-based)
     
     int p1Char, p2Char;
     char p1Name[20];
     char p2Name[20];
     bool p1Ready;
     bool p2Ready;
-    float startTimer; // Countdown Timer (-1 = off, >0 = counting)
+    int startTicks; // Countdown Timer in ticks (-1 = off, >0 = counting)
+
+    // Players (Host -> Client). Near the end, so only the used entries go on the wire.
+    Uint8 numPlayers;
+    NetPlayer players[GameConstants::MAX_PLAYERS];
+
+    // Desync Detection (both directions): digests of recent host ticks, the host's
+    // own or the client's rebuilt from snapshots. Optional: sent right after the
+    // used players, only when latest.tick != 0.
+    ChecksumReport checksums;
+
+    /** @brief Bytes up to the last used player (also what change detection hashes). */
+    size_t headerSize() const {
+        size_t n = numPlayers < GameConstants::MAX_PLAYERS ? numPlayers : GameConstants::MAX_PLAYERS;
+        return offsetof(Packet, players) + n * sizeof(NetPlayer);
+    }
+
+    bool hasChecksums() const { return checksums.latest.tick != 0; }
+
+    /** @brief Bytes actually sent. */
+    size_t wireSize() const {
+        return headerSize() + (hasChecksums() ? sizeof(ChecksumReport) : 0);
+    }
+
+    /** @brief Writes the wire form (wireSize() bytes) to `out`. */
+    void write(Uint8* out) const {
+        size_t header = headerSize();
+        memcpy(out, this, header);
+        if (hasChecksums()) memcpy(out + header, &checksums, sizeof(ChecksumReport));
+    }
+
+    /** @brief Parses a received datagram. Returns false if it isn't a whole Packet. */
+    bool read(const Uint8* in, size_t len) {
+        memset(this, 0, sizeof(Packet));
+        if (len < offsetof(Packet, players)) return false;
+        memcpy(this, in, offsetof(Packet, players));
+        if (numPlayers > GameConstants::MAX_PLAYERS) return false;
+        size_t header = headerSize();
+        if (len != header && len != header + sizeof(ChecksumReport)) return false;
+        memcpy(players, in + offsetof(Packet, players), header - offsetof(Packet, players));
+        if (len > header) memcpy(&checksums, in + header, sizeof(ChecksumReport));
+        return true;
+    }
 };
 
 class NetworkManager {
@@ -95,8 +163,46 @@ public:
     }
     
     // Peer Address
-    IPaddress peerIP;
+    IPaddress peerIP; // Where we send to. Points at the relay once relaying.
     bool hasPeer = false;
+    Uint32 punchStartTime = 0; // When we started punching the current peer
+    Uint64 sessionToken = 0; // Carried by our PUNCHes; 0 until both join codes are known
+
+    // Connectivity Checks (Hole Punch Scheduler)
+    // Every round probes all candidates once, then waits. The wait doubles each
+    // round (50ms -> 1s) so we punch hard early and then back off.
+    // Once connected we only send a keepalive if nothing else went out recently.
+    enum CandidateKind { CAND_PUBLIC, CAND_LOCAL, CAND_PREDICTED, CAND_RELAY };
+    struct PunchCandidate {
+        IPaddress addr;
+        CandidateKind kind;
+    };
+    std::vector<PunchCandidate> candidates;
+    Uint32 nextProbeTime = 0;
+    Uint32 probeInterval = 0;
+    Uint32 lastSendTime = 0;
+    const Uint32 PROBE_INTERVAL_MIN_MS = 50;
+    const Uint32 PROBE_INTERVAL_MAX_MS = 1000;
+    const Uint32 KEEPALIVE_INTERVAL_MS = 2000; // Well under typical 30s NAT UDP timeouts
+    const int PREDICTED_PORT_RANGE = 2; // Probe port +-1..N for sequential-allocation NATs
+
+    // Relay Fallback (optional, configured via AMPHITUDE_RELAY=host[:port])
+    IPaddress relayIP;
+    bool hasRelay = false;
+    bool usingRelay = false;
+    bool relayPaired = false;
+    IPaddress directPeerIP; // Original peer address, kept for the session ID
+    Uint64 relaySessionId = 0;
+    Uint32 lastRelayRegisterTime = 0;
+    const Uint32 PUNCH_TIMEOUT_MS = 4000; // Give up on direct punching after this
+    const Uint32 RELAY_REGISTER_INTERVAL_MS = 500;
+
+    // Same-Machine Transport (used once the peer has answered over it)
+    ShmTransport shm;
+    bool shmPeerSeen = false;
+    int shmPeerPort = 0;
+    Uint32 lastUdpPollTime = 0;
+    const Uint32 SHM_UDP_POLL_MS = 100; // Socket check while the peer is on shared memory
 
     // Reliability
     Uint32 localSeqId = 0;
@@ -107,6 +213,7 @@ public:
     std::string myPublicIP = "";
     int myPublicPort = 0;
     int myLocalPort = 0;
+    std::vector<Uint32> localHosts; // This machine's interface addresses
 
     bool init() {
         if (SDLNet_Init() < 0) return false;
@@ -130,8 +237,32 @@ public:
         }
         
         packet = SDLNet_AllocPacket(4096); // Allocated once
+        IPaddress addrs[16];
+        int count = SDLNet_GetLocalAddresses(addrs, 16);
+        for (int i = 0; i < count; ++i) localHosts.push_back(addrs[i].host);
+        configureRelay();
         return true;
     }
+
+    // Reads the optional relay server address from the environment
+    void configureRelay() {
+        const char* env = getenv("AMPHITUDE_RELAY");
+        if (!env || !*env) return;
+
+        std::string addr = env;
+        int port = RelayProtocol::DEFAULT_PORT;
+        size_t colonPos = addr.find(':');
+        if (colonPos != std::string::npos) {
+            port = atoi(addr.c_str() + colonPos + 1);
+            addr = addr.substr(0, colonPos);
+        }
+        if (port > 0 && port < 65536 && SDLNet_ResolveHost(&relayIP, addr.c_str(), port) == 0) {
+            hasRelay = true;
+            std::cout << "Relay Fallback: " << addr << ":" << port << std::endl;
+        } else {
+            std::cerr << "Failed to resolve relay: " << env << std::endl;
+        }
+    }
     
     void discoverPublicIP() {
         std::cout << "Discovering Public IP..." << std::endl;
@@ -155,12 +286,76 @@ public:
     void setPeer(const std::string& ipStr, int port) {
         if (SDLNet_ResolveHost(&peerIP, ipStr.c_str(), port) == 0) {
             hasPeer = true;
+            directPeerIP = peerIP;
+            usingRelay = false;
+            relayPaired = false;
+            punchStartTime = SDL_GetTicks();
+            sessionToken = 0;
+            buildCandidates();
+            restartProbing();
+
+            // Same machine: offer the shared-memory path alongside UDP
+            shmPeerSeen = false;
+            shmPeerPort = port;
+            if (isLoopback(peerIP)) shm.open(myLocalPort, port);
             std::cout << "Peer Set to: " << ipStr << ":" << port << std::endl;
         } else {
             std::cerr << "Failed to resolve peer: " << ipStr << std::endl;
         }
     }
 
+    // Send Scheduler
+    // Each kind of traffic has its own policy, so the send rate follows the game
+    // state instead of the render rate. `intervalMs` is a fixed-rate timer (0 = off);
+    // `onChange` additionally sends as soon as the payload differs from the last one.
+    enum Channel { CHANNEL_LOBBY, CHANNEL_SNAPSHOT, CHANNEL_INPUT, CHANNEL_GAMEOVER, CHANNEL_COUNT };
+    struct SendPolicy {
+        Uint32 intervalMs;
+        bool onChange;
+    };
+    SendPolicy sendPolicies[CHANNEL_COUNT] = {
+        {500, true},      // Lobby: changes + 2 Hz heartbeat
+        {1000 / 30, false}, // Snapshots: fixed 30 Hz
+        {1000 / 60, false}, // Client input: fixed 60 Hz (each packet carries 8 ticks of history)
+        {1000, true}      // Game Over: changes + 1 Hz heartbeat
+    };
+    Uint32 nextSendTime[CHANNEL_COUNT] = {};
+    Uint32 lastSentHash[CHANNEL_COUNT] = {};
+
+    void setSendPolicy(Channel c, Uint32 intervalMs, bool onChange) {
+        sendPolicies[c] = {intervalMs, onChange};
+        nextSendTime[c] = 0;
+    }
+
+    // True when the channel's fixed-rate timer has elapsed. Keeps the average
+    // rate exact (no drift from frame timing) but never bursts to catch up.
+    bool isSendDue(Channel c) {
+        const SendPolicy& policy = sendPolicies[c];
+        if (policy.intervalMs == 0) return false;
+        Uint32 now = SDL_GetTicks();
+        if (static_cast<Sint32>(now - nextSendTime[c]) < 0) return false;
+        nextSendTime[c] += policy.intervalMs;
+        if (static_cast<Sint32>(now - nextSendTime[c]) >= 0) nextSendTime[c] = now + policy.intervalMs;
+        return true;
+    }
+
+    // Decides whether `p` should go out now on channel `c` (changed or due).
+    // Packets must be zero-initialized (Packet p = {}) for change detection.
+    bool shouldSend(Channel c, const Packet& p) {
+        if (sendPolicies[c].onChange) {
+            // FNV-1a over the payload; seqId is assigned later in send()
+            Uint32 h = 2166136261u;
+            const Uint8* bytes = reinterpret_cast<const Uint8*>(&p);
+            for (size_t i = 0; i < p.headerSize(); ++i) h = (h ^ bytes[i]) * 16777619u;
+            if (h != lastSentHash[c]) {
+                lastSentHash[c] = h;
+                nextSendTime[c] = SDL_GetTicks() + sendPolicies[c].intervalMs; // Heartbeat restarts
+                return true;
+            }
+        }
+        return isSendDue(c);
+    }
+
     Uint32 lastReceiveTime = 0;
     const Uint32 TIMEOUT_MS = 5000; // 5 Seconds Timeout
 
@@ -180,16 +375,29 @@ public:
                 }
                 
                 // Retransmit
-                memcpy(packet->data, &it->p, sizeof(Packet));
-                packet->len = sizeof(Packet);
+                packet->len = static_cast<int>(it->p.wireSize());
+                it->p.write(packet->data);
                 packet->address = peerIP;
-                SDLNet_UDP_Send(udpSocket, -1, packet);
+                transmit();
                 it->lastSentTime = now;
+                lastSendTime = now;
             }
             ++it;
         }
         
-        // 2. Disconnect Detection (Heartbeat)
+        // 2. Relay Fallback: Direct punching didn't get through in time
+        if (!connected && hasRelay && !usingRelay && now - punchStartTime > PUNCH_TIMEOUT_MS) {
+            switchToRelay();
+        }
+        if (usingRelay && !relayPaired && now - lastRelayRegisterTime > RELAY_REGISTER_INTERVAL_MS) {
+            sendRelayRegister();
+            lastRelayRegisterTime = now;
+        }
+
+        // 3. Hole Punching / NAT Keepalive
+        updateConnectivity(now);
+
+        // 4. Disconnect Detection (Heartbeat)
         if (connected && now - lastReceiveTime > TIMEOUT_MS) {
             std::cout << "Connection Timed Out! (No packets for " << TIMEOUT_MS << "ms)" << std::endl;
             connected = false;
@@ -202,23 +410,155 @@ public:
         
         p.seqId = ++localSeqId;
         
-        memcpy(packet->data, &p, sizeof(Packet));
-        packet->len = sizeof(Packet);
+        packet->len = static_cast<int>(p.wireSize());
+        p.write(packet->data);
         packet->address = peerIP;
         
-        SDLNet_UDP_Send(udpSocket, -1, packet);
+        transmit();
+        lastSendTime = SDL_GetTicks();
     }
     
-    // Send a "Hole Punch" packet (Empty or Ping)
+    // Packs an address into the 48-bit key used for relay session IDs
+    static Uint64 endpointKey(const IPaddress& a) {
+        return (static_cast<Uint64>(a.host) << 16) | a.port;
+    }
+
+    // Route all traffic through the relay server instead of the direct path.
+    // Both peers derive the same session ID from the two join codes they exchanged.
+    void switchToRelay() {
+        IPaddress self;
+        if (myPublicIP.empty() || SDLNet_ResolveHost(&self, myPublicIP.c_str(), myPublicPort) != 0) {
+            std::cerr << "Relay Fallback unavailable: public address unknown" << std::endl;
+            hasRelay = false; // Don't retry every frame
+            return;
+        }
+        relaySessionId = RelayProtocol::sessionIdFor(endpointKey(self), endpointKey(directPeerIP));
+        usingRelay = true;
+        relayPaired = false;
+        peerIP = relayIP;
+        lastRelayRegisterTime = 0;
+        candidates.assign(1, {relayIP, CAND_RELAY});
+        restartProbing();
+        std::cout << "Hole Punch timed out. Switching to Relay (session "
+                  << std::hex << relaySessionId << std::dec << ")" << std::endl;
+    }
+
+    void sendRelayRegister() {
+        RelayProtocol::Control c;
+        RelayProtocol::makeControl(c, RelayProtocol::MSG_REGISTER, relaySessionId);
+        memcpy(packet->data, &c, sizeof(c));
+        packet->len = sizeof(c);
+        packet->address = relayIP;
+        SDLNet_UDP_Send(udpSocket, -1, packet);
+    }
+
+    static bool isLoopback(const IPaddress& a) {
+        return (SDL_SwapBE32(a.host) >> 24) == 127;
+    }
+
+    // Private (RFC 1918) addresses never need port prediction
+    static bool isPrivate(const IPaddress& a) {
+        Uint32 ip = SDL_SwapBE32(a.host);
+        return (ip >> 24) == 10 || (ip >> 20) == 0xAC1 || (ip >> 16) == 0xC0A8;
+    }
+
+    static bool sameAddress(const IPaddress& a, const IPaddress& b) {
+        return a.host == b.host && a.port == b.port;
+    }
+
+    // Our own socket, reached over loopback or any local interface (e.g. our LAN broadcast)
+    bool isSelf(const IPaddress& a) const {
+        if (SDL_SwapBE16(a.port) != myLocalPort) return false;
+        return isLoopback(a) || std::find(localHosts.begin(), localHosts.end(), a.host) != localHosts.end();
+    }
+
+    // Collects every address the peer might be reachable on
+    void buildCandidates() {
+        candidates.clear();
+        candidates.push_back({peerIP, CAND_PUBLIC});
+
+        int peerPort = SDL_SwapBE16(peerIP.port);
+        if (isLoopback(peerIP) || isPrivate(peerIP)) return; // Direct path, nothing to guess
+
+        IPaddress self;
+        bool selfKnown = !myPublicIP.empty() && SDLNet_ResolveHost(&self, myPublicIP.c_str(), myPublicPort) == 0;
+
+        // Both peers derive the same token from the two join codes; only a PUNCH
+        // carrying it may move us off the address we were given. It is salted so
+        // it never equals the relay session ID that the relay server sees.
+        if (selfKnown) {
+            sessionToken = RelayProtocol::sessionIdFor(endpointKey(self) ^ PUNCH_TOKEN_SALT,
+                                                      endpointKey(directPeerIP) ^ PUNCH_TOKEN_SALT);
+        }
+
+        // Same public IP = same NAT. Hairpinning often fails, so also try the
+        // peer directly on this machine and on the LAN (broadcast).
+        if (selfKnown && self.host == peerIP.host) {
+            IPaddress local;
+            if (SDLNet_ResolveHost(&local, "127.0.0.1", peerPort) == 0 && peerPort != myLocalPort) {
+                candidates.push_back({local, CAND_LOCAL});
+            }
+            local.host = INADDR_BROADCAST;
+            local.port = peerIP.port;
+            candidates.push_back({local, CAND_LOCAL});
+        }
+
+        // Port Prediction: Many NATs hand out ports sequentially, so the mapping
+        // the peer opened towards us is often right next to the one STUN saw.
+        for (int d = 1; d <= PREDICTED_PORT_RANGE; ++d) {
+            for (int sign = -1; sign <= 1; sign += 2) {
+                int port = peerPort + sign * d;
+                if (port <= 0 || port >= 65536) continue;
+                IPaddress predicted = peerIP;
+                predicted.port = SDL_SwapBE16(static_cast<Uint16>(port));
+                if (selfKnown && sameAddress(predicted, self)) continue; // Never punch ourselves
+                candidates.push_back({predicted, CAND_PREDICTED});
+            }
+        }
+    }
+
+    void restartProbing() {
+        probeInterval = PROBE_INTERVAL_MIN_MS;
+        nextProbeTime = 0; // Probe on the next update
+    }
+
+    // "PUNCH\0", then our session token when we have one
+    static const int PUNCH_LEN = 6;
+    static const int PUNCH_TOKEN_LEN = PUNCH_LEN + static_cast<int>(sizeof(Uint64));
+    static const Uint64 PUNCH_TOKEN_SALT = 0x50554E4348544F4BULL; // "PUNCHTOK"
+
+    void sendPunchTo(const IPaddress& addr) {
+        memcpy(packet->data, "PUNCH", PUNCH_LEN);
+        packet->len = PUNCH_LEN;
+        if (sessionToken != 0) {
+            memcpy(packet->data + PUNCH_LEN, &sessionToken, sizeof(sessionToken));
+            packet->len = PUNCH_TOKEN_LEN;
+        }
+        packet->address = addr;
+        // Probe the shared-memory path too, so a same-machine peer can discover it
+        if (shm.isOpen() && !shmPeerSeen && sameAddress(addr, peerIP)) shm.send(packet->data, packet->len);
+        transmit();
+        lastSendTime = SDL_GetTicks();
+    }
+
+    // Paced candidate probing before we connect, low-rate keepalive after
+    void updateConnectivity(Uint32 now) {
+        if (connected) {
+            if (now - lastSendTime > KEEPALIVE_INTERVAL_MS) sendPunchTo(peerIP);
+            return;
+        }
+        if (now < nextProbeTime) return;
+
+        for (const auto& c : candidates) sendPunchTo(c.addr);
+        nextProbeTime = now + probeInterval;
+        probeInterval = std::min(probeInterval * 2, PROBE_INTERVAL_MAX_MS);
+    }
+
+    // Start (or restart) hole punching right away, e.g. when the user presses ENTER
     void sendPunch() {
         if (!hasPeer || !udpSocket) return;
-        
-        const char* msg = "PUNCH";
-        memcpy(packet->data, msg, 6);
-        packet->len = 6;
-        packet->address = peerIP;
-        
-        SDLNet_UDP_Send(udpSocket, -1, packet);
+        restartProbing();
+        updateConnectivity(SDL_GetTicks());
     }
     
     // Send ACK for a received reliable packet
@@ -227,20 +567,42 @@ public:
         
         // ACK Packet Structure: Type=99 (Special)
         // Or just re-use Packet struct and set Type=99
-        Packet ackP;
+        Packet ackP = {};
         ackP.type = 99; // ACK
         ackP.seqId = seqId; // Echo back the ID
         
-        memcpy(packet->data, &ackP, sizeof(Packet));
-        packet->len = sizeof(Packet);
+        packet->len = static_cast<int>(ackP.wireSize());
+        ackP.write(packet->data);
         packet->address = peerIP;
+        transmit();
+    }
+
+    // Sends `packet` to packet->address. Traffic for a peer that has answered over
+    // shared memory takes that path; everything else (and a full ring) uses UDP.
+    void transmit() {
+        if (shmPeerSeen && sameAddress(packet->address, peerIP) && shm.send(packet->data, packet->len)) return;
         SDLNet_UDP_Send(udpSocket, -1, packet);
     }
 
+    // Drops the current segment and maps the one under the peer's name afresh
+    void reattachShm() {
+        std::cout << "Shared Memory peer left. Reattaching." << std::endl;
+        shmPeerSeen = false;
+        shm.open(myLocalPort, shmPeerPort);
+    }
+
     void disconnect() {
         connected = false;
         hasPeer = false;
         isHost = false;
+        usingRelay = false;
+        relayPaired = false;
+        shm.close();
+        shmPeerSeen = false;
+        for (int c = 0; c < CHANNEL_COUNT; ++c) {
+            nextSendTime[c] = 0;
+            lastSentHash[c] = 0;
+        }
         // Don't close socket, we might reuse it? 
         // Actually, better to keep it open to maintain the port mapping?
         // But for clean restart, maybe close?
@@ -250,23 +612,103 @@ public:
 
     bool receive(Packet& p) {
         if (!udpSocket) return false;
+
+        // The peer closed our segment (it restarted and may already be on a fresh
+        // one under the same name): map that one and go back to discovering
+        if (shm.isOpen() && shm.peerLeft()) reattachShm();
+
+        // Shared memory first (same-machine peer), then the socket
+        bool fromShm = false;
+        int shmLen = shm.receive(packet->data, packet->maxlen);
+        if (shmLen > 0) {
+            packet->len = shmLen;
+            packet->address = peerIP;
+            fromShm = true;
+            if (!shmPeerSeen) {
+                std::cout << "Peer reachable via Shared Memory. Switching transport." << std::endl;
+                shmPeerSeen = true;
+            }
+        }
         
-        if (SDLNet_UDP_Recv(udpSocket, packet)) {
+        // Once the peer talks over shared memory the socket only carries the odd
+        // overflow datagram, so don't pay a syscall for it on every poll: check it
+        // every SHM_UDP_POLL_MS, draining it while it has something
+        bool fromUdp = false;
+        if (!fromShm) {
+            bool onShm = shmPeerSeen && shm.isOpen();
+            Uint32 now = SDL_GetTicks();
+            if (!onShm || now - lastUdpPollTime >= SHM_UDP_POLL_MS) {
+                fromUdp = SDLNet_UDP_Recv(udpSocket, packet) > 0;
+                if (!fromUdp) lastUdpPollTime = now;
+            }
+        }
+
+        if (fromShm || fromUdp) {
             if (hasPeer) {
                  if (packet->address.host != peerIP.host || packet->address.port != peerIP.port) {
                      // Address mismatch, arguably should ignore, but for now allow (NAT Hairpinning might change IP)
                  }
             }
             
+            // Relay Control (Registration status) - not from the peer, no heartbeat
+            if (RelayProtocol::isControl(packet->data, packet->len)) {
+                RelayProtocol::Control c;
+                memcpy(&c, packet->data, sizeof(c));
+                if (usingRelay && c.sessionId == relaySessionId) {
+                    if (c.type == RelayProtocol::MSG_PAIRED && !relayPaired) {
+                        std::cout << "Relay Paired with Peer!" << std::endl;
+                        relayPaired = true;
+                    } else if (c.type == RelayProtocol::MSG_FULL) {
+                        std::cerr << "Relay is full." << std::endl;
+                    }
+                }
+                return false;
+            }
+
             // Update Heartbeat
             lastReceiveTime = SDL_GetTicks();
             
-            if (packet->len == 6 && strncmp((char*)packet->data, "PUNCH", 5) == 0) {
-                if (!connected) std::cout << "Recv PUNCH from Peer!" << std::endl;
+            if ((packet->len == PUNCH_LEN || packet->len == PUNCH_TOKEN_LEN) &&
+                strncmp((char*)packet->data, "PUNCH", 5) == 0) {
+                // Our own LAN broadcast / loopback probe coming back
+                if (isSelf(packet->address)) return false;
+
+                // A peer sharing our segment probes over it, so a UDP probe means
+                // it started a new one (e.g. it crashed and came back)
+                if (fromUdp && shmPeerSeen && sameAddress(packet->address, peerIP)) reattachShm();
+
+                Uint64 token = 0;
+                if (packet->len == PUNCH_TOKEN_LEN) memcpy(&token, packet->data + PUNCH_LEN, sizeof(token));
+
+                if (!connected) {
+                    // Anything but the address we were given must prove it's our peer.
+                    // The relay forwards the peer's PUNCHes once the peer relays, but
+                    // it is never the direct path.
+                    bool fromPeer = sameAddress(packet->address, peerIP);
+                    bool fromRelay = hasRelay && sameAddress(packet->address, relayIP);
+                    if (hasPeer && !usingRelay && !fromPeer &&
+                        (fromRelay || sessionToken == 0 || token != sessionToken)) {
+                        return false;
+                    }
+                    std::cout << "Recv PUNCH from Peer!" << std::endl;
+
+                    // Promote the path that answered: whichever candidate got through,
+                    // the source address is where the peer can actually be reached.
+                    if (hasPeer && !usingRelay && !fromPeer) {
+                        peerIP = packet->address;
+                        Uint32 ip = SDL_SwapBE32(peerIP.host);
+                        std::cout << "Promoted Candidate: "
+                                  << ((ip>>24)&0xFF) << "." << ((ip>>16)&0xFF) << "." << ((ip>>8)&0xFF) << "." << (ip&0xFF)
+                                  << ":" << SDL_SwapBE16(peerIP.port) << std::endl;
+                    }
+                    // Answer immediately so the peer can promote this pair too
+                    if (hasPeer) sendPunchTo(peerIP);
+                }
                 
                 // Auto-Latch: If we don't have a peer (we are waiting Host), adopt this sender!
                 if (!hasPeer) {
                     peerIP = packet->address;
+                    directPeerIP = peerIP;
                     hasPeer = true;
                     // Log IP
                     Uint32 ip = SDL_SwapBE32(peerIP.host);
@@ -279,9 +721,14 @@ public:
                 return false; 
             }
             
-            if (packet->len == sizeof(Packet)) {
+            // Game packets are variable-length: the player array is cut to numPlayers
+            // and the checksum report is optional
+            if (packet->len >= static_cast<int>(offsetof(Packet, players)) &&
+                packet->len <= static_cast<int>(sizeof(Packet))) {
+                if (!p.read(packet->data, static_cast<size_t>(packet->len))) {
+                    return false; // Malformed
+                }
                 connected = true; 
-                memcpy(&p, packet->data, sizeof(Packet));
                 
                 // ... (Ack Logic) ...
                 if (p.type == 99) {
@@ -311,6 +758,7 @@ public:
     }
     
     void cleanup() {
+        shm.close();
         if (udpSocket) SDLNet_UDP_Close(udpSocket);
         if (packet) SDLNet_FreePacket(packet);
         SDLNet_Quit();
@@ -0,0 +1,222 @@
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <vector>
+#include "JobSystem.h"
+
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
+#error "Particles are drawn with SDL_RenderGeometry: SDL 2.0.18 or newer is required"
+#endif
+
+/**
+ * @struct ParticleEmitter
+ * @brief What one burst looks like. Effects are described by one of these
+ * instead of code, so tuning an effect is editing a table entry.
+ */
+struct ParticleEmitter {
+    int count;              ///< Particles per burst
+    float speed;            ///< Initial velocity is uniform in [-speed, speed] per axis (pixels per tick)
+    float gravity;          ///< Added to vy every tick
+    float drag;             ///< Velocity multiplier per tick (1 = none)
+    int lifetime;           ///< Ticks
+    float size;             ///< Edge of the square, pixels
+    SDL_Color startColor;   ///< Color at birth...
+    SDL_Color endColor;     ///< ...faded linearly to this at death
+};
+
+/**
+ * @class ParticleSystem
+ * @brief Fixed-capacity, structure-of-arrays particle pool.
+ *
+ * All storage is allocated once in the constructor; emitting and updating never
+ * allocate, and a burst that doesn't fit is clipped instead of growing the pool,
+ * so a large hit effect can't cause a frame spike. Live particles are packed at
+ * `0 .. count()-1`; dead ones are replaced by the last live one.
+ *
+ * The per-tick update is a handful of straight loops over float arrays with no
+ * branches, which the compiler vectorizes; big pools are also split across the
+ * job system's threads (particles don't interact). Rendering builds one vertex buffer
+ * for the particles on screen and draws them with a single SDL_RenderGeometry call.
+ *
+ * Particles are purely visual, so the game keeps only those near the camera:
+ * ones that drift out of the active area are dropped (see setActiveArea()).
+ *
+ * Emission is deterministic for a given seed (xorshift32), so the host and the
+ * client build the same effect from a replicated GameEvent.
+ */
+class ParticleSystem {
+public:
+    static const int CAPACITY = 16384;
+    static const int PARTICLES_PER_JOB = 4096; ///< Chunk size for threaded updates
+
+    ParticleSystem() {
+        x.resize(CAPACITY); y.resize(CAPACITY);
+        vx.resize(CAPACITY); vy.resize(CAPACITY);
+        prevX.resize(CAPACITY); prevY.resize(CAPACITY);
+        age.resize(CAPACITY); ageStep.resize(CAPACITY);
+        gravity.resize(CAPACITY); drag.resize(CAPACITY); size.resize(CAPACITY);
+        startColor.resize(CAPACITY); endColor.resize(CAPACITY);
+
+        // Two triangles per particle; the index pattern never changes
+        vertices.resize(CAPACITY * 4);
+        indices.resize(CAPACITY * 6);
+        for (int i = 0; i < CAPACITY; ++i) {
+            int v = i * 4;
+            int* idx = &indices[i * 6];
+            idx[0] = v; idx[1] = v + 1; idx[2] = v + 2;
+            idx[3] = v + 2; idx[4] = v + 1; idx[5] = v + 3;
+        }
+    }
+
+    int count() const { return live; }
+    void clear() { live = 0; }
+
+    /**
+     * @brief Spawns one burst at (px, py). Particles beyond the capacity are dropped.
+     * @param seed Seed for the velocities (same seed, same burst).
+     */
+    void emit(const ParticleEmitter& em, float px, float py, Uint32 seed) {
+        Uint32 state = seed * 2654435761u + 0x9E3779B9u;
+        if (state == 0) state = 1;
+        float step = em.lifetime > 0 ? 1.0f / em.lifetime : 1.0f;
+
+        int n = em.count;
+        if (n > CAPACITY - live) n = CAPACITY - live;
+        for (int k = 0; k < n; ++k) {
+            int i = live++;
+            x[i] = prevX[i] = px;
+            y[i] = prevY[i] = py;
+            vx[i] = (nextUnit(state) * 2 - 1) * em.speed;
+            vy[i] = (nextUnit(state) * 2 - 1) * em.speed;
+            age[i] = 0;
+            ageStep[i] = step;
+            gravity[i] = em.gravity;
+            drag[i] = em.drag;
+            size[i] = em.size;
+            startColor[i] = em.startColor;
+            endColor[i] = em.endColor;
+        }
+    }
+
+    /** @brief Particles leaving this box (arena coordinates) are dropped at the next update. */
+    void setActiveArea(float x, float y, float w, float h) {
+        areaLeft = x; areaTop = y;
+        areaRight = x + w; areaBottom = y + h;
+    }
+
+    /**
+     * @brief Advances every particle one tick and drops the expired and distant ones.
+     * @param jobs Spreads the integration over worker threads (optional).
+     */
+    void update(JobSystem* jobs = nullptr) {
+        if (jobs) jobs->parallelFor(0, live, PARTICLES_PER_JOB, [this](int begin, int end) { integrate(begin, end); });
+        else integrate(0, live);
+
+        // Compact: the last live particle fills each hole (order doesn't matter)
+        for (int i = 0; i < live; ) {
+            bool away = x[i] < areaLeft || x[i] > areaRight || y[i] < areaTop || y[i] > areaBottom;
+            if (age[i] >= 0.9999f || away) moveLast(i); // Tolerate rounding in the summed steps
+            else ++i;
+        }
+    }
+
+    /** @brief Copies positions into prevX/prevY (start of a tick). */
+    void storePrevious() {
+        std::copy(x.begin(), x.begin() + live, prevX.begin());
+        std::copy(y.begin(), y.begin() + live, prevY.begin());
+    }
+
+    /**
+     * @brief Draws the particles inside the view in one call.
+     * @param alpha Interpolation factor between the last two ticks.
+     * @param viewX, viewY, viewW, viewH Camera view in arena coordinates; particles
+     * outside it get no vertices.
+     */
+    void render(SDL_Renderer* renderer, float alpha, float viewX, float viewY, float viewW, float viewH) {
+        int drawn = 0;
+        for (int i = 0; i < live; ++i) {
+            float s = size[i];
+            float cx = prevX[i] + (x[i] - prevX[i]) * alpha - viewX;
+            float cy = prevY[i] + (y[i] - prevY[i]) * alpha - viewY;
+            if (cx + s <= 0 || cy + s <= 0 || cx >= viewW || cy >= viewH) continue;
+            SDL_Color c = fade(startColor[i], endColor[i], age[i]);
+
+            SDL_Vertex* v = &vertices[drawn * 4];
+            v[0].position = {cx, cy};         v[1].position = {cx + s, cy};
+            v[2].position = {cx, cy + s};     v[3].position = {cx + s, cy + s};
+            for (int k = 0; k < 4; ++k) {
+                v[k].color = c;
+                v[k].tex_coord = {0, 0};
+            }
+            drawn++;
+        }
+        if (drawn == 0) return;
+
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_RenderGeometry(renderer, nullptr, vertices.data(), drawn * 4, indices.data(), drawn * 6);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    }
+
+private:
+    int live = 0;
+    float areaLeft = -1e30f, areaTop = -1e30f, areaRight = 1e30f, areaBottom = 1e30f; ///< Active area
+
+    // Columns (CAPACITY long, first `live` in use)
+    std::vector<float> x, y, vx, vy;
+    std::vector<float> prevX, prevY;  ///< Position at the start of the tick (render interpolation)
+    std::vector<float> age;           ///< 0 at birth, 1 at death
+    std::vector<float> ageStep;       ///< 1 / lifetime
+    std::vector<float> gravity, drag, size;
+    std::vector<SDL_Color> startColor, endColor;
+
+    // Render buffers (reused every frame)
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    /** @brief Moves particles [begin, end) one tick. Touches nothing outside that range. */
+    void integrate(int begin, int end) {
+        float* __restrict px = x.data();
+        float* __restrict py = y.data();
+        float* __restrict pvx = vx.data();
+        float* __restrict pvy = vy.data();
+        float* __restrict pa = age.data();
+        const float* __restrict step = ageStep.data();
+        const float* __restrict g = gravity.data();
+        const float* __restrict d = drag.data();
+
+        for (int i = begin; i < end; ++i) {
+            pvy[i] = (pvy[i] + g[i]) * d[i];
+            pvx[i] *= d[i];
+            px[i] += pvx[i];
+            py[i] += pvy[i];
+            pa[i] += step[i];
+        }
+    }
+
+    static float nextUnit(Uint32& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(state >> 8) / 16777216.0f; // [0, 1)
+    }
+
+    static SDL_Color fade(SDL_Color a, SDL_Color b, float t) {
+        if (t > 1.0f) t = 1.0f;
+        return {static_cast<Uint8>(a.r + (b.r - a.r) * t), static_cast<Uint8>(a.g + (b.g - a.g) * t),
+                static_cast<Uint8>(a.b + (b.b - a.b) * t), static_cast<Uint8>(a.a + (b.a - a.a) * t)};
+    }
+
+    void moveLast(int i) {
+        int last = --live;
+        x[i] = x[last]; y[i] = y[last];
+        vx[i] = vx[last]; vy[i] = vy[last];
+        prevX[i] = prevX[last]; prevY[i] = prevY[last];
+        age[i] = age[last]; ageStep[i] = ageStep[last];
+        gravity[i] = gravity[last]; drag[i] = drag[last]; size[i] = size[last];
+        startColor[i] = startColor[last]; endColor[i] = endColor[last];
+    }
+};
+
+#endif // PARTICLESYSTEM_H
@@ -5,49 +5,87 @@
 #include <string>
 #include <vector>
 #include "Structs.h"
+#include "EntityStore.h"
+#include "Level.h"
+
+/** @brief What dealt a hit (match statistics). */
+enum DamageSource : Uint8 {
+    DAMAGE_COLLISION = 0, ///< Bump or basic attack
+    DAMAGE_RAM,           ///< Rhino charge
+    DAMAGE_PROJECTILE,    ///< Fireball
+    DAMAGE_FALL,          ///< Fell off the arena
+    DAMAGE_SOURCE_COUNT
+};
+
+/**
+ * @struct PlayerState
+ * @brief Everything about a player that the simulation reads or writes.
+ *
+ * Plain data (no pointers, no strings), so it is saved and restored with a
+ * memcpy (see WorldState). Presentation (name, textures, sprite sheet layout,
+ * correction smoothing) stays in Player.
+ */
+struct PlayerState {
+    int id = 0;             ///< Player ID (1-based)
+    float x = 0, y = 0;     ///< Position
+    float vx = 0, vy = 0;   ///< Velocity
+    float width = 0, height = 0;
+    float hp = 100, maxHp = 100; ///< Health points
+    int facing = 1;         ///< 1 for Right, -1 for Left
+
+    // Power-ups
+    int powerTimer = 0;     ///< Duration remaining for power-up
+    int invincible = 0;     ///< Invincibility frames remaining
+    int attackCooldown = 0; ///< Timer for attack cooldown
+
+    // Position at the start of the last simulation tick; render() interpolates from here to (x, y)
+    float prevX = 0, prevY = 0;
+
+    // Animation (advanced by the simulation, so replays look the same)
+    int currentFrame = 0; ///< Current animation frame index
+    int frameTimer = 0;   ///< Timer to control animation speed
+    int animRow = 0;      ///< Current row in sprite sheet (0=Run, 1=Jump, 2=Idle)
+
+    // Bytes last, so the struct has no padding (saved images hash the same)
+    PowerType power = POWER_NONE; ///< Current active power (behaviour in ABILITIES)
+    bool onGround = false;  ///< True if standing on a platform
+    bool keyLeft = false, keyRight = false, keyJump = false, keyAttack = false, keyDown = false; ///< Input State
+    Uint8 reserved = 0;
+};
+static_assert(sizeof(PlayerState) == 80, "PlayerState must stay free of padding");
 
 /**
  * @class Player
  * @brief Represents a playable character in the game.
  * 
  * Handles movement physics, collision detection, animation state,
- * combat logic (health, damage), and rendering.
+ * combat logic (health, damage), and rendering. The simulated part lives in
+ * the PlayerState base.
  */
-class Player {
+class Player : public PlayerState {
 public:
-    int id;             ///< Player ID (1 or 2)
-    float x, y;         ///< Position
-    float vx, vy;       ///< Velocity
-    float width, height;
     SDL_Color color;    ///< Tint color for the sprite
     std::string name;   ///< Display name
-    float hp, maxHp;    ///< Health points
-    bool onGround;      ///< True if standing on a platform
-    int facing;         ///< 1 for Right, -1 for Left
-    
-    // Power-ups
-    std::string power;  ///< Current active power-up type
-    int powerTimer;     ///< Duration remaining for power-up
-    int invincible;     ///< Invincibility frames remaining
-    
-    // Input State
-    bool keyLeft, keyRight, keyJump, keyAttack, keyDown;
+
+    // Visual-only offset used to smooth out prediction corrections (pixels).
+    // Decays towards 0 every frame; never affects physics.
+    float renderOffsetX = 0, renderOffsetY = 0;
     
     // Animation
     SDL_Texture* texture; ///< Current active texture
     SDL_Texture* normalTexture; ///< Standard sprite sheet
     SDL_Texture* dragonTexture; ///< Dragon sprite sheet
     SDL_Texture* rhinoTexture;  ///< Rhino sprite sheet
-    int currentFrame = 0; ///< Current animation frame index
-    int frameTimer = 0;   ///< Timer to control animation speed
-    int attackCooldown = 0; ///< Timer for attack cooldown
     int numFrames = 3;    ///< Total frames in current animation
     int frameWidth = 0;   ///< Width of a single sprite frame
     int frameHeight = 0;  ///< Height of a single sprite frame
-    int animRow = 0;      ///< Current row in sprite sheet (0=Run, 1=Jump, 2=Idle)
     int totalColumns = 1;
     int totalRows = 1;
 
+    float damageTaken[DAMAGE_SOURCE_COUNT] = {}; ///< HP lost this match, by source (statistics only)
+
+    std::vector<Uint16> nearbyPlatforms; ///< Scratch for broadphase queries
+
     Player();
 
     /**
@@ -76,14 +114,25 @@ public:
      * Handles invincibility frames and shield power-up logic.
      * 
      * @param damage Amount of damage to take.
-     * @param particles Reference to particle list for hit effects.
+     * @param events Receives HIT / POWER_LOST events for the visual effects.
+     * @param source What dealt it (statistics).
+     */
+    void takeDamage(float damage, std::vector<GameEvent>& events, DamageSource source = DAMAGE_COLLISION);
+
+    /**
+     * @brief Drops the current power and reverts to the normal sprite.
+     */
+    void losePower();
+
+    /**
+     * @brief Picks the sprite sheet for the current power.
      */
-    void takeDamage(float damage, std::vector<Particle>& particles);
+    void selectTexture();
 
     /**
-     * @brief Spawns particles when hit.
+     * @brief Queues an event at the player's center.
      */
-    void createHitParticles(std::vector<Particle>& particles);
+    void emitEvent(std::vector<GameEvent>& events, Uint8 type) const;
 
     /**
      * @brief Updates player state for the current frame.
@@ -91,13 +140,30 @@ public:
      * Handles input processing, physics (gravity, velocity), collision detection,
      * animation updates, and power-up timers.
      * 
-     * @param platforms List of platforms for collision.
+     * @param level Arena (platforms for collision, respawn points).
      * @param projectiles List of projectiles (to fire).
-     * @param particles List of particles (for effects).
+     * @param events Gameplay events (for effects).
+     */
+    void update(const Level& level,
+                EntityStore& projectiles,
+                std::vector<GameEvent>& events);
+
+    /**
+     * @brief Puts the player against the face of `platform` that the move (dx, dy)
+     * ran into and stops it on that axis. A player that started inside the
+     * platform is pushed out through the shallowest face instead (see sweepAABB()).
+     */
+    void stopAt(const Platform& platform, float dx, float dy);
+
+    /**
+     * @brief Packs the five input keys into one byte (bit 0 = Left ... bit 4 = Attack).
+     */
+    Uint8 getInputBits() const;
+
+    /**
+     * @brief Sets the input keys from a byte produced by getInputBits().
      */
-    void update(const std::vector<Platform>& platforms,
-                std::vector<Projectile>& projectiles,
-                std::vector<Particle>& particles);
+    void setInputBits(Uint8 bits);
 
     /**
      * @brief Renders the player to the screen.
@@ -106,8 +172,10 @@ public:
      * Also draws the health bar and power-up indicators.
      * 
      * @param renderer SDL Renderer.
+     * @param alpha Interpolation between the previous and current tick (0..1).
+     * @param viewX, viewY Top-left of the camera view (arena to screen offset).
      */
-    void render(SDL_Renderer* renderer) const;
+    void render(SDL_Renderer* renderer, float alpha, float viewX, float viewY) const;
 };
 
 #endif // PLAYER_H
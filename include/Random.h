@@ -0,0 +1,70 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <SDL2/SDL.h>
+#include <chrono>
+#include <random>
+
+/** @brief Independent streams drawn from one match seed. */
+enum RandomStream : Uint32 {
+    STREAM_GAMEPLAY = 1, ///< Simulation outcomes (power-up spawns); identical on every peer
+    STREAM_COSMETIC = 2  ///< Effect seeds; may differ without affecting the match
+};
+
+/**
+ * @struct Random
+ * @brief Seeded xoshiro128** generator in 16 bytes of plain state.
+ *
+ * Every random outcome of a match comes from a stream seeded from the match
+ * seed, so peers, replays and restored snapshots that share the seed draw the
+ * same numbers. A stream is just this object: no global state and no locks,
+ * so separate threads use separate streams, and copying one (a WorldState
+ * does) forks it.
+ */
+struct Random {
+    Uint32 s[4] = {0x9E3779B9u, 0x243F6A88u, 0xB7E15162u, 0x5A827999u};
+
+    /** @brief Seeds `stream` of `seed` (splitmix64 expansion, never the all-zero state). */
+    void seed(Uint32 seed, Uint32 stream) {
+        Uint64 z = (static_cast<Uint64>(stream) << 32 | seed) + 0x9E3779B97F4A7C15ULL;
+        for (int i = 0; i < 4; i += 2) {
+            Uint64 v = (z += 0x9E3779B97F4A7C15ULL);
+            v = (v ^ (v >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            v = (v ^ (v >> 27)) * 0x94D049BB133111EBULL;
+            v ^= v >> 31;
+            s[i] = static_cast<Uint32>(v);
+            s[i + 1] = static_cast<Uint32>(v >> 32);
+        }
+        if ((s[0] | s[1] | s[2] | s[3]) == 0) s[0] = 1;
+    }
+
+    Uint32 next() {
+        Uint32 result = rotl(s[1] * 5, 7) * 9;
+        Uint32 t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 11);
+        return result;
+    }
+
+    /** @brief Uniform in [0, n) (multiply-shift, no division). */
+    Uint32 below(Uint32 n) { return static_cast<Uint32>((static_cast<Uint64>(next()) * n) >> 32); }
+
+    /** @brief Uniform in [0, 1). */
+    float unit() { return (next() >> 8) * (1.0f / 16777216.0f); }
+
+    /** @brief A fresh seed for a new match (OS entropy mixed with the clock). */
+    static Uint32 entropySeed() {
+        std::random_device device;
+        Uint64 clock = static_cast<Uint64>(std::chrono::steady_clock::now().time_since_epoch().count());
+        return device() ^ static_cast<Uint32>(clock) ^ static_cast<Uint32>(clock >> 32);
+    }
+
+private:
+    static Uint32 rotl(Uint32 x, int k) { return (x << k) | (x >> (32 - k)); }
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,75 @@
+#ifndef RELAYPROTOCOL_H
+#define RELAYPROTOCOL_H
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @namespace RelayProtocol
+ * @brief Wire format shared by the game and the `amphitude-relay` server.
+ *
+ * The relay is a dumb forwarder for peers that cannot hole punch (symmetric NAT,
+ * carrier-grade NAT). A peer registers with a small control datagram carrying a
+ * session ID; once both peers of a session are registered, every other datagram
+ * from one of them is forwarded verbatim to the other. Game packets carry no
+ * relay header, so switching to the relay only changes the destination address.
+ */
+namespace RelayProtocol {
+    /** @brief Default UDP port the relay listens on. */
+    const int DEFAULT_PORT = 50500;
+
+    /** @brief "ARLY" - marks a relay control datagram. */
+    const char MAGIC[4] = {'A', 'R', 'L', 'Y'};
+
+    /** @brief Control message types. */
+    enum MessageType : uint8_t {
+        MSG_REGISTER = 1, ///< Peer -> Relay: join session
+        MSG_WAITING  = 2, ///< Relay -> Peer: registered, partner not seen yet
+        MSG_PAIRED   = 3, ///< Relay -> Peer: both peers registered, forwarding active
+        MSG_FULL     = 4  ///< Relay -> Peer: session or relay is full
+    };
+
+    /**
+     * @struct Control
+     * @brief Fixed 16-byte control datagram. Data packets never have this size.
+     */
+    struct Control {
+        char magic[4];
+        uint8_t type;
+        uint8_t reserved[3];
+        uint64_t sessionId; ///< Host byte order; both ends are little-endian in practice
+    };
+    static_assert(sizeof(Control) == 16, "Relay control datagram must stay 16 bytes");
+
+    /** @brief True if the datagram is a relay control message. */
+    inline bool isControl(const void* data, int len) {
+        return len == static_cast<int>(sizeof(Control)) && memcmp(data, MAGIC, 4) == 0;
+    }
+
+    /** @brief Builds a control message in place. */
+    inline void makeControl(Control& c, uint8_t type, uint64_t sessionId) {
+        memcpy(c.magic, MAGIC, 4);
+        c.type = type;
+        c.reserved[0] = c.reserved[1] = c.reserved[2] = 0;
+        c.sessionId = sessionId;
+    }
+
+    /**
+     * @brief Derives the session ID both peers agree on without talking.
+     *
+     * Each peer knows its own public endpoint (STUN) and the peer's endpoint (the
+     * join code they typed). Sorting the pair makes the result symmetric.
+     */
+    inline uint64_t sessionIdFor(uint64_t endpointA, uint64_t endpointB) {
+        uint64_t lo = endpointA < endpointB ? endpointA : endpointB;
+        uint64_t hi = endpointA < endpointB ? endpointB : endpointA;
+        // SplitMix64 finalizer over the combined pair
+        uint64_t z = lo * 0x9E3779B97F4A7C15ULL ^ (hi + 0x632BE59BD9B4E019ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        return z ? z : 1; // 0 is reserved as "empty" in the relay tables
+    }
+}
+
+#endif // RELAYPROTOCOL_H
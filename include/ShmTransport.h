@@ -0,0 +1,211 @@
+#ifndef SHMTRANSPORT_H
+#define SHMTRANSPORT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class ShmTransport
+ * @brief Datagram transport between two game instances on the same machine.
+ *
+ * Two single-producer/single-consumer rings live in one POSIX shared-memory
+ * segment, one per direction. Sending and receiving are a memcpy plus an atomic
+ * store: no syscalls, no kernel UDP stack. Messages behave like datagrams
+ * (whole messages, dropped when the ring is full), so NetworkManager can use it
+ * exactly like the UDP socket.
+ *
+ * Both instances derive the segment name from their two local ports, so no
+ * extra handshake is needed. Whoever creates the segment removes the name
+ * once both sides have mapped it (or on close, if the peer never came), so
+ * the other instance never unlinks a segment that a newer session may be
+ * using. Once unlinked, a reconnecting instance creates a fresh segment, so
+ * the side left behind must notice (peerLeft()) and open() again.
+ * On Windows the transport simply never opens.
+ */
+class ShmTransport {
+public:
+    static const uint32_t RING_SLOTS = 64;      ///< Messages in flight per direction
+    static const uint32_t MAX_MESSAGE = 2048;   ///< Larger than any game Packet
+
+    ~ShmTransport() { close(); }
+
+    /**
+     * @brief Maps (creating if needed) the segment shared with the peer.
+     * @param myPort Our local UDP port.
+     * @param peerPort The peer's local UDP port.
+     */
+    bool open(int myPort, int peerPort) {
+#ifndef _WIN32
+        close();
+        if (myPort == peerPort) return false;
+
+        int lo = myPort < peerPort ? myPort : peerPort;
+        int hi = myPort < peerPort ? peerPort : myPort;
+        name = "/amphitude_" + std::to_string(lo) + "_" + std::to_string(hi);
+
+        side = myPort == lo ? 0 : 1;
+        if (!map()) return false;
+        if (!creator && segment->attached[side].load(std::memory_order_acquire)) {
+            // Our side is still marked from an instance that died on this port:
+            // the segment is left over, so start a fresh one
+            munmap(segment, sizeof(Segment));
+            segment = nullptr;
+            shm_unlink(name.c_str());
+            if (!map()) return false;
+        }
+
+        outgoing = &segment->rings[side];
+        incoming = &segment->rings[1 - side];
+
+        // Anything already queued for us is from an older session
+        incoming->tail.store(incoming->head.load(std::memory_order_acquire), std::memory_order_release);
+        segment->attached[side].store(1, std::memory_order_release);
+        unlinkOnceAttached();
+
+        std::cout << "Shared Memory Transport: " << name << std::endl;
+        return true;
+#else
+        (void)myPort; (void)peerPort;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Unmaps the segment. A creator whose peer never attached also
+     * removes the name, so the next session starts clean.
+     */
+    void close() {
+#ifndef _WIN32
+        if (!segment) return;
+        segment->attached[side].store(0, std::memory_order_release);
+        munmap(segment, sizeof(Segment));
+        if (creator && !unlinked) shm_unlink(name.c_str());
+        segment = nullptr;
+        incoming = outgoing = nullptr;
+#endif
+    }
+
+    bool isOpen() const { return segment != nullptr; }
+
+    /**
+     * @brief True once a peer that had the segment mapped has closed it (it may
+     * be back on a newer segment under the same name).
+     */
+    bool peerLeft() {
+        if (!segment) return false;
+        bool attached = segment->attached[1 - side].load(std::memory_order_acquire) != 0;
+        if (attached) peerWasAttached = true;
+        return peerWasAttached && !attached;
+    }
+
+    /**
+     * @brief Queues one message. Returns false (message dropped) if the ring is full.
+     */
+    bool send(const void* data, int len) {
+        if (!outgoing || len <= 0 || static_cast<uint32_t>(len) > MAX_MESSAGE) return false;
+        uint32_t head = outgoing->head.load(std::memory_order_relaxed);
+        uint32_t tail = outgoing->tail.load(std::memory_order_acquire);
+        if (head - tail >= RING_SLOTS) return false;
+
+        Slot& slot = outgoing->slots[head % RING_SLOTS];
+        slot.len = static_cast<uint32_t>(len);
+        memcpy(slot.data, data, len);
+        outgoing->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Dequeues one message into `data`.
+     * @return Message length, or 0 if nothing is waiting.
+     */
+    int receive(void* data, int maxLen) {
+        if (!incoming) return 0;
+        unlinkOnceAttached();
+        uint32_t tail = incoming->tail.load(std::memory_order_relaxed);
+        uint32_t head = incoming->head.load(std::memory_order_acquire);
+        if (tail == head) return 0;
+
+        const Slot& slot = incoming->slots[tail % RING_SLOTS];
+        int len = static_cast<int>(slot.len);
+        if (len > maxLen) len = maxLen;
+        memcpy(data, slot.data, len);
+        incoming->tail.store(tail + 1, std::memory_order_release);
+        return len;
+    }
+
+private:
+    struct Slot {
+        uint32_t len;
+        uint8_t data[MAX_MESSAGE];
+    };
+
+    // Head and tail sit on separate cache lines so producer and consumer don't false-share
+    struct Ring {
+        alignas(64) std::atomic<uint32_t> head; ///< Written by the producer only
+        alignas(64) std::atomic<uint32_t> tail; ///< Written by the consumer only
+        alignas(64) Slot slots[RING_SLOTS];
+    };
+
+    struct Segment {
+        Ring rings[2]; ///< [0]: lower port -> higher port, [1]: the other way
+        std::atomic<uint32_t> attached[2]; ///< Side i has the segment mapped
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free,
+                  "Shared-memory rings need address-free atomics");
+
+#ifndef _WIN32
+    /** @brief Creates the segment, or maps the existing one if the peer created it. */
+    bool map() {
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        creator = fd >= 0;
+        if (!creator) fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0) return false;
+        // A freshly created segment is zero-filled, which is a valid empty state
+        if (ftruncate(fd, sizeof(Segment)) != 0) {
+            ::close(fd);
+            if (creator) shm_unlink(name.c_str());
+            return false;
+        }
+        void* mem = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mem == MAP_FAILED) {
+            if (creator) shm_unlink(name.c_str());
+            return false;
+        }
+        segment = static_cast<Segment*>(mem);
+        unlinked = false;
+        peerWasAttached = false;
+        return true;
+    }
+#endif
+
+    /** @brief Creator only: drops the name as soon as both sides hold a mapping. */
+    void unlinkOnceAttached() {
+#ifndef _WIN32
+        if (!creator || unlinked || !segment->attached[1 - side].load(std::memory_order_acquire)) return;
+        shm_unlink(name.c_str());
+        unlinked = true;
+#endif
+    }
+
+    Segment* segment = nullptr;
+    Ring* incoming = nullptr;
+    Ring* outgoing = nullptr;
+    std::string name;
+    int side = 0;         ///< Our ring index: 0 if our port is the lower one
+    bool creator = false; ///< We created the segment, so we remove its name
+    bool unlinked = false;
+    bool peerWasAttached = false; ///< Seen the peer's side flag set on this mapping
+};
+
+#endif // SHMTRANSPORT_H
@@ -0,0 +1,112 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * @class SpatialGrid
+ * @brief Uniform-grid broadphase over axis-aligned boxes.
+ *
+ * Items are small integer IDs (an index into the caller's own array) inserted
+ * into every cell their box touches. A query only visits the cells under the
+ * query box, so its cost follows how crowded that area is, not how many items
+ * exist. Anything outside the grid bounds is kept in the nearest edge cell, so
+ * entities that leave the screen are still found.
+ *
+ * Used twice: a static grid of platforms built once per level, and a dynamic
+ * grid that is cleared and refilled every tick. clear() keeps the cell
+ * capacity, so refilling does not allocate once it has warmed up.
+ *
+ * query() writes only to the caller's vector, so several threads can query the
+ * same grid at once (each with its own output vector).
+ */
+class SpatialGrid {
+public:
+    /**
+     * @brief Sets the covered area and cell size, dropping all items.
+     * @param cell Cell edge in pixels; pick roughly the size of a typical item.
+     */
+    void init(float originX, float originY, float width, float height, float cell) {
+        ox = originX;
+        oy = originY;
+        cellSize = cell;
+        invCell = 1.0f / cell;
+        cols = std::max(1, static_cast<int>(std::ceil(width * invCell)));
+        rows = std::max(1, static_cast<int>(std::ceil(height * invCell)));
+        cells.assign(static_cast<size_t>(cols) * rows, std::vector<Uint16>());
+    }
+
+    /** @brief Empties every cell (capacity is kept). */
+    void clear() {
+        for (auto& c : cells) c.clear();
+    }
+
+    /** @brief Adds item `id` to every cell overlapped by the box. */
+    void insert(Uint16 id, float x, float y, float w, float h) {
+        int c0, r0, c1, r1;
+        cellRange(x, y, w, h, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                cells[r * cols + c].push_back(id);
+            }
+        }
+    }
+
+    /**
+     * @brief Collects the items whose cells overlap the box (candidates only:
+     * callers still run the exact overlap test).
+     *
+     * Each item is reported once and `out` is sorted by ID, so resolving the
+     * candidates in order gives the same result as a brute-force loop.
+     */
+    void query(float x, float y, float w, float h, std::vector<Uint16>& out) const {
+        out.clear();
+        int c0, r0, c1, r1;
+        cellRange(x, y, w, h, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                const std::vector<Uint16>& cell = cells[r * cols + c];
+                out.insert(out.end(), cell.begin(), cell.end());
+            }
+        }
+        // Items spanning several cells appear once per cell: sort, then drop repeats
+        if (out.size() > 1) {
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+        }
+    }
+
+    /** @brief Items in one cell (the cell containing world point x, y). */
+    const std::vector<Uint16>& cellAt(float x, float y) const {
+        return cells[row(y) * cols + col(x)];
+    }
+
+    int getCols() const { return cols; }
+    int getRows() const { return rows; }
+    float getCellSize() const { return cellSize; }
+
+private:
+    float ox = 0, oy = 0;
+    float cellSize = 1, invCell = 1;
+    int cols = 0, rows = 0;
+    std::vector<std::vector<Uint16>> cells;    ///< Row-major, item IDs per cell
+
+    int col(float x) const {
+        int c = static_cast<int>(std::floor((x - ox) * invCell));
+        return c < 0 ? 0 : (c >= cols ? cols - 1 : c);
+    }
+    int row(float y) const {
+        int r = static_cast<int>(std::floor((y - oy) * invCell));
+        return r < 0 ? 0 : (r >= rows ? rows - 1 : r);
+    }
+
+    void cellRange(float x, float y, float w, float h, int& c0, int& r0, int& c1, int& r1) const {
+        c0 = col(x); c1 = col(x + w);
+        r0 = row(y); r1 = row(y + h);
+    }
+};
+
+#endif // SPATIALGRID_H
@@ -14,46 +14,43 @@ struct Platform {
 };
 
 /**
- * @struct Projectile
- * @brief Represents a moving object fired by a player.
+ * @brief Power-up / ability kinds. One byte, so it is cheap to store per entity
+ * and to send. Behaviour lives in the ABILITIES table (Abilities.h).
  */
-struct Projectile {
-    float x, y;       ///< Current position
-    float vx, vy;     ///< Velocity vector
-    float width, height;
-    int owner;        ///< ID of the player who fired this (0 or 1)
-    std::string type; ///< Type of projectile (e.g., "fire")
+enum PowerType : Uint8 {
+    POWER_NONE = 0,
+    POWER_FIRE,   ///< Dragon: shoots fireballs
+    POWER_SHIELD, ///< Rhino: charge attack, absorbs a hit
+    POWER_HEALTH, ///< Instant heal
+    POWER_COUNT
 };
 
 /**
- * @struct PowerUp
- * @brief Represents a collectible item that gives abilities.
+ * @struct GameEvent
+ * @brief A discrete gameplay moment (hit, pickup, ...) that has a visual effect.
+ *
+ * The simulation emits events instead of spawning particles directly. The host
+ * replicates them to the client, and both sides build the same effect locally
+ * from `seed`, so effects match without sending particle state. Kept POD and
+ * compact (12 bytes) because it goes on the wire as-is.
  */
-struct PowerUp {
-    float x, y;
-    float width, height;
-    std::string type; ///< "fire", "speed", "health", "shield", "star"
-    int bobTimer = 0; ///< Used for the floating animation
-    int lifetime = 0; ///< Frames until it disappears
-};
-
-/**
- * @struct Particle
- * @brief Represents a simple visual effect (confetti, sparks).
- */
-struct Particle {
-    float x, y;
-    float vx, vy;
-    int life;         ///< Remaining frames before it disappears
-    SDL_Color color;  ///< Color of the particle
-    bool active;      ///< Is the particle currently active?
+struct GameEvent {
+    enum Type : Uint8 {
+        HIT = 1,          ///< Player lost HP (arg = player index)
+        POWER_LOST,       ///< Shield absorbed a hit / power broken (arg = player index)
+        PICKUP,           ///< Power-up collected (arg = player index)
+        CLASH,            ///< Two charging rhinos collided
+        PROJECTILE_SPAWN, ///< Fireball launched (arg = owner index)
+        CHARGE            ///< Rhino dash started (arg = player index)
+    };
 
-    void update() {
-        x += vx;
-        y += vy;
-        life--;
-        if (life <= 0) active = false;
-    }
+    Uint16 seq;   ///< Host-assigned sequence number (dedup), 0 until assigned
+    Uint16 tick;  ///< Simulation tick it happened on (low 16 bits)
+    Uint8 type;   ///< GameEvent::Type
+    Uint8 arg;    ///< Type-specific (usually a player index)
+    Sint16 x, y;  ///< World position of the effect
+    Uint16 seed;  ///< Seed for the cosmetic randomness
 };
+static_assert(sizeof(GameEvent) == 12, "GameEvent is sent on the wire");
 
 #endif // STRUCTS_H
@@ -2,8 +2,12 @@
 #define UTILS_H
 
 #include <SDL2/SDL.h>
+#include <utility>
 #include <vector>
 #include "Structs.h"
+#include "EntityStore.h"
+#include "Level.h"
+#include "Random.h"
 
 /**
  * @brief Checks for Axis-Aligned Bounding Box (AABB) collision between two rectangles.
@@ -21,6 +25,35 @@
 bool checkCollision(float x1, float y1, float w1, float h1,
                    float x2, float y2, float w2, float h2);
 
+/**
+ * @brief Swept AABB test: when does rect 1, moving by (dx, dy), first touch rect 2?
+ *
+ * Rects that already overlap at the start are a hit at time 0, with the
+ * normal of the face rect 1 is least deep behind (the way out). Only
+ * grazing each other's edges does not count as a hit.
+ *
+ * @param nx, ny Set to the surface normal of rect 2 at the contact.
+ * @return Time of impact as a fraction of the move (0..1), or -1 if there is none.
+ */
+float sweepAABB(float x1, float y1, float w1, float h1, float dx, float dy,
+                float x2, float y2, float w2, float h2, float& nx, float& ny);
+
+/**
+ * @brief Earliest time of impact of a moving rect against the level's platforms.
+ *
+ * Only platforms near the swept area get the exact sweep. Baked arenas use
+ * their compiled-in sweep (see BakedArenas); otherwise a batch overlap scan
+ * picks the platforms in small levels (see BATCH_SCAN_PLATFORMS), the level's
+ * collision grid in large ones.
+ *
+ * @param scratch Reused buffer for the grid query.
+ * @param hit Set to the index of the platform hit first, or -1.
+ * @return Time of impact (0..1); 1 if the whole move is free, 0 if the rect
+ * starts inside a platform.
+ */
+float sweepPlatforms(float x, float y, float w, float h, float dx, float dy,
+                     const Level& level, std::vector<Uint16>& scratch, int& hit);
+
 /**
  * @brief Clamps a value between a minimum and maximum.
  * 
@@ -34,16 +67,11 @@ bool checkCollision(float x1, float y1, float w1, float h1,
 float clamp(float value, float min, float max);
 
 /**
- * @brief Spawns a burst of particles at a location.
- * 
- * @param particles Reference to the particle list to add to.
- * @param x X position of the burst center.
- * @param y Y position of the burst center.
- * @param color Color of the particles.
- * @param count Number of particles to spawn.
+ * @brief Linear interpolation from `a` (t = 0) to `b` (t = 1).
  */
-void createParticles(std::vector<Particle>& particles, float x, float y,
-                    SDL_Color color, int count);
+inline float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
 
 /**
  * @brief Draws a filled rectangle using SDL.
@@ -70,13 +98,59 @@ void drawRect(SDL_Renderer* renderer, float x, float y, float w, float h,
  */
 void drawCircle(SDL_Renderer* renderer, int cx, int cy, int radius, SDL_Color color);
 
+/** @brief Where a power-up appears and what it gives. */
+struct PowerUpSpawn {
+    float x, y;
+    PowerType type;
+};
+
 /**
- * @brief Spawns a random power-up on a random platform.
- * 
- * @param powerUps Reference to the power-up list.
- * @param platforms Reference to the platform list (to choose a location).
+ * @brief Draws the next power-up spawn: a random type in one of the level's power-up zones.
+ *
+ * Always takes the same number of draws from `rng`, so a peer replaying the
+ * stream gets the same sequence of spawns.
+ *
+ * @param level The arena (its weighted spawn table picks the zone).
+ * @param rng The match's gameplay stream.
+ */
+PowerUpSpawn rollPowerUp(const Level& level, Random& rng);
+
+/**
+ * @brief Applies a replicated entity list from a snapshot in place, matched by network ID.
+ *
+ * Entities that survive are updated where they are (local-only state such as
+ * animation timers is kept), new IDs are created, and missing ones are removed.
+ * No allocation happens unless the store has to grow past its previous capacity.
+ *
+ * @param local The local entity store.
+ * @param net Snapshot entries (NetEntity must have an `id` member).
+ * @param count Number of snapshot entries.
+ * @param apply Callback `(EntityStore&, size_t index, const NetEntity&, bool created)`
+ *              copying replicated fields.
  */
-void spawnPowerUp(std::vector<PowerUp>& powerUps,
-                 const std::vector<Platform>& platforms);
+template <typename NetEntity, typename ApplyFn>
+void applyReplicated(EntityStore& local, const NetEntity* net, int count, ApplyFn apply) {
+    // Drop everything the snapshot no longer has (swap-and-pop, so re-check slot i)
+    for (size_t i = 0; i < local.size(); ) {
+        bool present = false;
+        for (int k = 0; k < count && !present; ++k) present = (net[k].id == local.netId[i]);
+        if (present) ++i;
+        else local.remove(i);
+    }
+
+    // Update survivors in place, create the rest
+    for (int k = 0; k < count; ++k) {
+        size_t found = local.size();
+        for (size_t i = 0; i < local.size(); ++i) {
+            if (local.netId[i] == net[k].id) { found = i; break; }
+        }
+        bool created = (found == local.size());
+        if (created) {
+            found = local.add(0, 0, 0, 0, POWER_NONE);
+            local.netId[found] = net[k].id;
+        }
+        apply(local, found, net[k], created);
+    }
+}
 
 #endif // UTILS_H
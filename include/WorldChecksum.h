@@ -0,0 +1,231 @@
+#ifndef WORLDCHECKSUM_H
+#define WORLDCHECKSUM_H
+
+#include <SDL2/SDL.h>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include "Constants.h"
+
+/**
+ * @struct StateHasher
+ * @brief Incremental FNV-1a hash over simulation state. No allocation, a few
+ * cycles per byte, so it can run every tick.
+ */
+struct StateHasher {
+    Uint64 h = 1469598103934665603ULL;
+
+    void addBytes(const void* data, size_t len) {
+        const Uint8* b = static_cast<const Uint8*>(data);
+        for (size_t i = 0; i < len; ++i) {
+            h ^= b[i];
+            h *= 1099511628211ULL;
+        }
+    }
+
+    template <typename T>
+    void add(const T& v) {
+        static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                      "Use addFloat/addString for non-integer state");
+        addBytes(&v, sizeof(v));
+    }
+
+    /** @brief Hashes the exact bit pattern (-0 folded into +0). */
+    void addFloat(float f) {
+        if (f == 0.0f) f = 0.0f;
+        Uint32 bits;
+        memcpy(&bits, &f, sizeof(bits));
+        add(bits);
+    }
+
+    void addString(const std::string& s) {
+        add(static_cast<Uint32>(s.size()));
+        addBytes(s.data(), s.size());
+    }
+
+    /** @brief 32-bit result (folded), what goes on the wire. */
+    Uint32 value() const { return static_cast<Uint32>(h ^ (h >> 32)); }
+};
+
+/**
+ * @struct PlayerDigest
+ * @brief Simulation-relevant state of one player, compact enough to send.
+ */
+struct PlayerDigest {
+    float x, y, vx, vy;
+    float hp;
+    Sint16 powerTimer;
+    Sint16 invincible;
+    Sint16 attackCooldown;
+    Sint8 facing;
+    Uint8 onGround;
+    Uint8 power;      ///< PowerType
+    Uint8 reserved[3];
+};
+
+/**
+ * @struct WorldDigest
+ * @brief Checksum of the world after one host tick, plus the values it was
+ * built from so a mismatch can be printed field by field.
+ *
+ * Only what a snapshot rebuilds on the client goes in: the host digests its
+ * world after simulating the tick, the client right after applying the
+ * snapshot of that tick, so both describe the same moment. Entity lists are
+ * summarised as a count and a sub-hash; the section hashes say which part of
+ * the world diverged.
+ */
+struct WorldDigest {
+    Uint32 tick;     ///< Host simTick the digest belongs to (0 = empty slot)
+    Uint32 hash;     ///< Combined checksum of everything below
+    Sint32 gameTicks;
+    PlayerDigest players[GameConstants::MAX_PLAYERS];
+    Uint8 numProjectiles;
+    Uint8 numPowerUps;
+    Uint8 skippedPlayer; ///< Player index left out of the hash (predicted), 0xFF = none
+    Uint8 numPlayers;
+    Uint32 projectileHash;
+    Uint32 powerUpHash;
+};
+
+/**
+ * @struct ChecksumReport
+ * @brief What a peer sends about the host ticks it digested recently.
+ *
+ * The newest digest goes in full; the few before it only as (tick, hash) pairs,
+ * so one lost packet doesn't hide where the worlds started to differ.
+ */
+struct ChecksumReport {
+    static const int RECENT = 4;
+    WorldDigest latest;
+    Uint32 recentTicks[RECENT];  ///< Older ticks, newest first (0 = none)
+    Uint32 recentHashes[RECENT];
+};
+
+/**
+ * @class DesyncDetector
+ * @brief Keeps the local digests of recent host ticks and compares them with
+ * the peer's reports. The client only has digests for the ticks it got a
+ * snapshot of; the others are skipped.
+ *
+ * Only the first diverging tick is logged (with both digests when available);
+ * after that it stays quiet until the worlds agree again, so it is cheap and
+ * quiet enough to leave on.
+ */
+class DesyncDetector {
+public:
+    static const int HISTORY = 128; ///< Ticks kept (~2s at 60 Hz, well above RTT)
+
+    void reset() {
+        memset(history, 0, sizeof(history));
+        newestTick = 0;
+        reportedTick = 0;
+        diverged = false;
+        firstDivergedTick = 0;
+    }
+
+    /** @brief Stores the local digest for its tick. */
+    void record(const WorldDigest& d) {
+        history[d.tick % HISTORY] = d;
+        if (d.tick > newestTick) newestTick = d.tick;
+    }
+
+    /** @brief Local digest for `tick`, or nullptr if it was never recorded / overwritten. */
+    const WorldDigest* find(Uint32 tick) const {
+        const WorldDigest& d = history[tick % HISTORY];
+        return (tick != 0 && d.tick == tick) ? &d : nullptr;
+    }
+
+    /**
+     * @brief Whether a report is worth sending: a report names RECENT + 1 ticks,
+     * so one every RECENT ticks still covers each of them.
+     */
+    bool reportDue() const {
+        return newestTick != 0 && newestTick - reportedTick >= ChecksumReport::RECENT;
+    }
+
+    /** @brief Fills a report with the newest local digest and the ones before it. */
+    void fillReport(ChecksumReport& r) {
+        memset(&r, 0, sizeof(r));
+        const WorldDigest* newest = find(newestTick);
+        if (!newest) return;
+        r.latest = *newest;
+        reportedTick = newestTick;
+
+        // Walk back over the ring for the next older recorded ticks
+        int n = 0;
+        for (Uint32 k = 1; k < HISTORY && k < newestTick && n < ChecksumReport::RECENT; ++k) {
+            const WorldDigest* d = find(newestTick - k);
+            if (!d) continue;
+            r.recentTicks[n] = d->tick;
+            r.recentHashes[n] = d->hash;
+            n++;
+        }
+    }
+
+    /**
+     * @brief Compares a peer report against our own digests (oldest tick first).
+     * @return false if a mismatch was found.
+     */
+    bool check(const ChecksumReport& r, const char* peerName) {
+        bool ok = true;
+        for (int i = ChecksumReport::RECENT - 1; i >= 0; --i) {
+            if (r.recentTicks[i] == 0) continue;
+            ok = compare(r.recentTicks[i], r.recentHashes[i], nullptr, peerName) && ok;
+        }
+        if (r.latest.tick != 0) {
+            ok = compare(r.latest.tick, r.latest.hash, &r.latest, peerName) && ok;
+        }
+        return ok;
+    }
+
+    bool diverged = false;
+    Uint32 firstDivergedTick = 0;
+
+private:
+    WorldDigest history[HISTORY] = {};
+    Uint32 newestTick = 0;
+    Uint32 reportedTick = 0; ///< Newest tick of the last report filled
+
+    bool compare(Uint32 tick, Uint32 hash, const WorldDigest* remote, const char* peerName) {
+        const WorldDigest* local = find(tick);
+        if (!local) return true; // Too old or never simulated here, nothing to compare
+
+        if (local->hash == hash) {
+            if (diverged && tick > firstDivergedTick) {
+                std::cout << "[Desync] Back in sync at tick " << tick << std::endl;
+                diverged = false;
+            }
+            return true;
+        }
+
+        if (diverged) return false; // Already reported this divergence
+        diverged = true;
+        firstDivergedTick = tick;
+        std::cout << "[Desync] First diverging tick " << tick << " (local "
+                  << std::hex << local->hash << " vs " << peerName << " " << hash
+                  << std::dec << ")" << std::endl;
+        dump("local", *local);
+        if (remote) dump(peerName, *remote);
+        else std::cout << "  (" << peerName << " only sent the hash for this tick)" << std::endl;
+        return false;
+    }
+
+    static void dump(const char* who, const WorldDigest& d) {
+        std::cout << "  " << who << ": tick=" << d.tick << " time=" << d.gameTicks
+                  << " proj=" << static_cast<int>(d.numProjectiles) << "/" << std::hex << d.projectileHash
+                  << " pu=" << std::dec << static_cast<int>(d.numPowerUps) << "/" << std::hex << d.powerUpHash
+                  << std::dec << std::endl;
+        for (int i = 0; i < d.numPlayers && i < GameConstants::MAX_PLAYERS; ++i) {
+            if (d.skippedPlayer == i) continue;
+            const PlayerDigest& p = d.players[i];
+            std::cout << "    P" << (i + 1) << " pos=(" << p.x << "," << p.y << ") vel=(" << p.vx << "," << p.vy
+                      << ") hp=" << p.hp << " power=" << static_cast<int>(p.power)
+                      << "/" << p.powerTimer << " inv=" << p.invincible << " cd=" << p.attackCooldown
+                      << " face=" << static_cast<int>(p.facing) << " ground=" << static_cast<int>(p.onGround)
+                      << std::endl;
+        }
+    }
+};
+
+#endif // WORLDCHECKSUM_H
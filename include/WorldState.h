@@ -0,0 +1,122 @@
+#ifndef WORLDSTATE_H
+#define WORLDSTATE_H
+
+#include <SDL2/SDL.h>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "Constants.h"
+#include "EntityStore.h"
+#include "Player.h"
+#include "Random.h"
+
+/**
+ * @struct WorldState
+ * @brief The whole simulation in one flat, trivially copyable block.
+ *
+ * Game::saveWorld() fills it and Game::restoreWorld() puts it back, a handful
+ * of memcpys each way; copying a WorldState around is a single memcpy. This is
+ * what rollback, replays, bot search and crash dumps build on. Presentation
+ * (names, textures, particles) and the network session are not part of it.
+ *
+ * Unused entity slots are zero (saveWorld clears the block first) and the
+ * records have no padding, so equal worlds have byte-identical images and
+ * hash() can work on the raw bytes.
+ */
+struct WorldState {
+    static const int PROJECTILE_SLOTS = (GameConstants::MAX_PROJECTILES + 3) & ~3;
+    static const int POWER_UP_SLOTS = (GameConstants::MAX_POWER_UPS + 3) & ~3;
+
+    Uint32 simTick;           ///< Ticks since the match started
+    Sint32 gameTicks;         ///< Match time remaining
+    Sint32 powerUpSpawnTicks; ///< Until the next power-up spawn
+    Sint32 winnerId;          ///< 0 = None/Draw, otherwise the winner's player ID
+    Uint32 matchSeed;         ///< Seed the random streams started from
+    Uint32 powerUpSpawns;     ///< Power-ups rolled so far (the next one's network ID)
+    Random gameplayRng;       ///< Stream positions, so a restored world draws what it would have
+    Random cosmeticRng;
+    Uint16 nextNetId;         ///< Last network ID handed out
+    Uint8 gameState;          ///< Game::GameState (PLAYING, GAMEOVER, ...)
+    Uint8 numPlayers;
+    PlayerState players[GameConstants::MAX_PLAYERS];
+    EntityStore::Snapshot<PROJECTILE_SLOTS> projectiles;
+    EntityStore::Snapshot<POWER_UP_SLOTS> powerUps;
+
+    /**
+     * @brief Fast 64-bit hash of the image (8 bytes per step), for comparing
+     * worlds, e.g. a replay against its recording.
+     */
+    Uint64 hash() const {
+        const Uint8* bytes = reinterpret_cast<const Uint8*>(this);
+        Uint64 h = 0x9E3779B97F4A7C15ULL ^ sizeof(WorldState);
+        size_t i = 0;
+        for (; i + 8 <= sizeof(WorldState); i += 8) {
+            Uint64 word;
+            memcpy(&word, bytes + i, 8);
+            h = (h ^ word) * 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 32;
+        }
+        for (; i < sizeof(WorldState); ++i) h = (h ^ bytes[i]) * 0x100000001B3ULL;
+        return h;
+    }
+};
+static_assert(std::is_trivially_copyable<WorldState>::value, "WorldState is copied with memcpy");
+
+/**
+ * @namespace WorldFile
+ * @brief Versioned binary image of a WorldState (crash dumps, saved replays).
+ *
+ * Layout: Header | WorldState. Bump VERSION whenever WorldState, PlayerState or
+ * EntityStore::Snapshot changes; the size check also catches a forgotten bump.
+ */
+namespace WorldFile {
+    const char MAGIC[4] = {'A', 'W', 'L', 'D'};
+    const Uint16 VERSION = 2;
+
+    struct Header {
+        char magic[4];
+        Uint16 version;
+        Uint16 headerSize;
+        Uint32 stateSize;   ///< sizeof(WorldState) of the writer
+        Uint32 reserved;
+        Uint64 hash;        ///< WorldState::hash() of the payload
+    };
+    static_assert(sizeof(Header) == 24, "World file header layout changed");
+
+    inline std::vector<Uint8> serialize(const WorldState& w) {
+        Header h;
+        memset(&h, 0, sizeof(h));
+        memcpy(h.magic, MAGIC, 4);
+        h.version = VERSION;
+        h.headerSize = sizeof(Header);
+        h.stateSize = sizeof(WorldState);
+        h.hash = w.hash();
+
+        std::vector<Uint8> out(sizeof(Header) + sizeof(WorldState));
+        memcpy(out.data(), &h, sizeof(h));
+        memcpy(out.data() + sizeof(Header), &w, sizeof(WorldState));
+        return out;
+    }
+
+    /**
+     * @brief Reads an image written by serialize().
+     * @return false (and `w` untouched) if it is from another version or corrupt.
+     */
+    inline bool deserialize(const Uint8* data, size_t len, WorldState& w) {
+        if (len != sizeof(Header) + sizeof(WorldState)) return false;
+        Header h;
+        memcpy(&h, data, sizeof(h));
+        if (memcmp(h.magic, MAGIC, 4) != 0 || h.version != VERSION || h.headerSize != sizeof(Header) ||
+            h.stateSize != sizeof(WorldState)) return false;
+
+        WorldState loaded;
+        memcpy(&loaded, data + sizeof(Header), sizeof(WorldState));
+        if (loaded.hash() != h.hash || loaded.numPlayers > GameConstants::MAX_PLAYERS ||
+            loaded.projectiles.count > WorldState::PROJECTILE_SLOTS ||
+            loaded.powerUps.count > WorldState::POWER_UP_SLOTS) return false;
+        w = loaded;
+        return true;
+    }
+}
+
+#endif // WORLDSTATE_H
@@ -0,0 +1,74 @@
+#include "BakedArenas.h"
+#include "Structs.h"
+#include "Utils.h"
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+// Platform I of arena P: does it touch the swept area? The area is the batch scan's
+// (grown by a pixel), so the same platforms get the exact sweep. No branches.
+template <const LevelFormat::Rect* P, size_t I>
+inline unsigned nearBit(float left, float top, float right, float bottom) {
+    constexpr LevelFormat::Rect r = P[I];
+    return static_cast<unsigned>((left < r.x + r.w) & (right > r.x) & (top < r.y + r.h) & (bottom > r.y)) << I;
+}
+
+template <const LevelFormat::Rect* P, size_t I>
+inline void sweepOne(float x, float y, float w, float h, float dx, float dy, float& toi, int& hit) {
+    constexpr LevelFormat::Rect r = P[I];
+    float nx, ny;
+    float t = sweepAABB(x, y, w, h, dx, dy, r.x, r.y, r.w, r.h, nx, ny);
+    if (t >= 0 && (t < toi || (t == toi && hit < 0))) { // Ties keep the lowest index
+        toi = t;
+        hit = static_cast<int>(I);
+    }
+}
+
+template <const LevelFormat::Rect* P, size_t... I>
+inline float sweepUnrolled(float x, float y, float w, float h, float dx, float dy, int& hit,
+                           std::index_sequence<I...>) {
+    static_assert(sizeof...(I) <= 32, "Nearby mask is one word");
+    hit = -1;
+    float left = (dx < 0 ? x + dx : x) - 1, top = (dy < 0 ? y + dy : y) - 1;
+    float right = left + (w + std::abs(dx) + 2), bottom = top + (h + std::abs(dy) + 2);
+    unsigned nearby = (nearBit<P, I>(left, top, right, bottom) | ...);
+
+    // A projectile in flight usually has nothing nearby: one well-predicted branch
+    float toi = 1.0f;
+    if (nearby) ((nearby >> I & 1 ? sweepOne<P, I>(x, y, w, h, dx, dy, toi, hit) : void()), ...);
+    return toi;
+}
+
+template <const LevelFormat::Rect* P, size_t N>
+float sweepArena(float x, float y, float w, float h, float dx, float dy, int& hit) {
+    return sweepUnrolled<P>(x, y, w, h, dx, dy, hit, std::make_index_sequence<N>());
+}
+
+template <const LevelFormat::Rect* P, size_t N>
+constexpr BakedArenas::Arena bake(const char* name) {
+    return {name, P, N, &sweepArena<P, N>};
+}
+
+// Dispatch table: every arena baked into this build (one per BakedArenas::TABLES entry)
+const BakedArenas::Arena ARENAS[] = {
+    bake<BakedArenas::CLASSIC, std::size(BakedArenas::CLASSIC)>(BakedArenas::TABLES[0].name)
+};
+static_assert(std::size(ARENAS) == std::size(BakedArenas::TABLES), "Bake every table");
+
+}
+
+const BakedArenas::Arena* BakedArenas::find(const Platform* platforms, size_t count) {
+    for (const Arena& arena : ARENAS) {
+        if (arena.platformCount != count) continue;
+        bool same = true;
+        for (size_t i = 0; i < count && same; ++i) {
+            const LevelFormat::Rect& r = arena.platforms[i];
+            const Platform& p = platforms[i];
+            same = r.x == p.x && r.y == p.y && r.w == p.width && r.h == p.height;
+        }
+        if (same) return &arena;
+    }
+    return nullptr;
+}
@@ -0,0 +1,162 @@
+#include "Bot.h"
+#include "Game.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+// Moves the search picks from: keys held together for Config::moveTicks
+struct Move {
+    bool left, right, jump, attack;
+};
+const Move MOVES[] = {
+    {false, false, false, false}, // Wait
+    {true, false, false, false},  // Left
+    {false, true, false, false},  // Right
+    {false, false, true, false},  // Jump
+    {true, false, true, false},   // Jump left
+    {false, true, true, false},   // Jump right
+    {false, false, false, true},  // Attack
+    {true, false, false, true},   // Attack left
+    {false, true, false, true}    // Attack right
+};
+const int NUM_MOVES = sizeof(MOVES) / sizeof(MOVES[0]);
+
+const Bot::Config CONFIGS[Bot::DIFFICULTY_COUNT] = {
+    {1, 1, 12, 15, 300},  // Easy: one move ahead, slow to react
+    {2, 3, 10, 8, 1000},  // Normal
+    {3, 5, 8, 4, 2000}    // Hard: three moves ahead, reacts every 4 ticks
+};
+const char* DIFFICULTY_NAMES[Bot::DIFFICULTY_COUNT] = {"Easy", "Normal", "Hard"};
+}
+
+Bot::Config Bot::configFor(Difficulty difficulty) {
+    return CONFIGS[difficulty];
+}
+
+const char* Bot::difficultyName(Difficulty difficulty) {
+    return DIFFICULTY_NAMES[difficulty];
+}
+
+Bot::Bot(int playerIndex, int numPlayers, Difficulty difficulty, const char* levelPath, JobSystem* jobs, bool async)
+    : self(playerIndex), chosenDifficulty(difficulty), arenaPath(levelPath ? levelPath : ""),
+      config(CONFIGS[difficulty]), jobs(jobs), async(async), sandbox(new Game()) {
+    // The sandbox builds its roster once; restoreWorld() only replaces the simulated state
+    if (!sandbox->initHeadless(numPlayers, levelPath)) sandbox->initHeadless(numPlayers, nullptr);
+    sandbox->startMatch(0);
+    states.resize(2 * config.beamWidth * NUM_MOVES);
+    parents.reserve(config.beamWidth);
+    children.reserve(config.beamWidth * NUM_MOVES);
+}
+
+Bot::~Bot() {
+    reset();
+}
+
+void Bot::reset() {
+    if (searching) jobs->wait(group);
+    searching = false;
+    result = -1;
+    currentMove = 0;
+    ticksToReplan = 0;
+}
+
+void Bot::update(Game& game) {
+    std::vector<Player>& players = game.getPlayers();
+    if (self >= static_cast<int>(players.size())) return;
+
+    // Pick up a finished background search
+    if (searching && group.done()) {
+        searching = false;
+        if (result >= 0) currentMove = result;
+    }
+
+    if (!searching && --ticksToReplan <= 0) {
+        ticksToReplan = config.replanTicks;
+        if (players[self].hp > 0 && game.saveWorld(root)) {
+            if (async && jobs && jobs->workerCount() > 0) {
+                searching = true;
+                jobs->runBackground(group, [this] { search(); });
+            } else {
+                search();
+                if (result >= 0) currentMove = result;
+            }
+        }
+    }
+    applyMove(players[self], currentMove);
+}
+
+void Bot::search() {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point deadline = Clock::now() + std::chrono::microseconds(config.budgetMicros);
+    result = -1;
+
+    // Best first move of the deepest finished depth (a partial depth only if none finished)
+    int half = config.beamWidth * NUM_MOVES;
+    int childBase = 0;
+    parents.assign(1, {-1, 0, -1});
+    for (int depth = 0; depth < config.depth; ++depth) {
+        children.clear();
+        bool outOfTime = false;
+        for (size_t p = 0; p < parents.size() && !outOfTime; ++p) {
+            const Node parent = parents[p];
+            for (int m = 0; m < NUM_MOVES; ++m) {
+                if (Clock::now() >= deadline) {
+                    outOfTime = true;
+                    break;
+                }
+                sandbox->restoreWorld(parent.state < 0 ? root : states[parent.state]);
+                float score = rollout(m);
+                int slot = childBase + static_cast<int>(children.size());
+                sandbox->saveWorld(states[slot]);
+                children.push_back({parent.firstMove < 0 ? m : parent.firstMove, score, slot});
+            }
+        }
+        if (children.empty() || (outOfTime && result >= 0)) return;
+
+        // Keep the best lines for the next depth
+        size_t keep = std::min(children.size(), static_cast<size_t>(config.beamWidth));
+        std::partial_sort(children.begin(), children.begin() + keep, children.end(),
+                          [](const Node& a, const Node& b) { return a.score > b.score; });
+        result = children[0].firstMove;
+        if (outOfTime) return;
+        parents.assign(children.begin(), children.begin() + keep);
+        childBase = half - childBase;
+    }
+}
+
+float Bot::rollout(int move) {
+    for (int t = 0; t < config.moveTicks && sandbox->matchRunning(); ++t) {
+        applyMove(sandbox->getPlayers()[self], move);
+        sandbox->simulateTick();
+    }
+    return evaluate();
+}
+
+float Bot::evaluate() const {
+    const std::vector<Player>& players = sandbox->getPlayers();
+    const Player& me = players[self];
+    if (me.hp <= 0) return -1000.0f;
+    if (!sandbox->matchRunning()) return sandbox->getWinnerId() == me.id ? 1000.0f : -500.0f;
+
+    // Own health counts double, so trades that cost as much as they deal are avoided
+    float score = me.hp * 2.0f;
+    float nearest = 1e9f;
+    for (const Player& p : players) {
+        if (&p == &me || p.hp <= 0) continue;
+        score -= p.hp;
+        nearest = std::min(nearest, std::abs(p.x - me.x) + std::abs(p.y - me.y));
+    }
+    if (me.power != POWER_NONE) score += 20.0f;
+    if (nearest < 1e9f) score -= nearest * 0.02f; // Close in rather than idle
+    return score;
+}
+
+void Bot::applyMove(Player& p, int move) {
+    const Move& m = MOVES[move];
+    p.keyLeft = m.left;
+    p.keyRight = m.right;
+    p.keyJump = m.jump;
+    p.keyAttack = m.attack;
+    p.keyDown = false;
+}
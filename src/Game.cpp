@@ -1,11 +1,89 @@
 #include "Game.h"
 #include "Constants.h"
 #include "Utils.h"
+#include "Abilities.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <cstdlib>
+#include <fstream>
 #include <SDL2/SDL_image.h>
 
+namespace {
+// Effect presets: count, speed, gravity, drag, lifetime, size, start color, end color
+const ParticleEmitter HIT_EFFECT = {GameConstants::HIT_PARTICLE_COUNT, 4.0f, 0.0f, 1.0f,
+                                    GameConstants::PARTICLE_LIFETIME, 3.0f, {255, 0, 0, 255}, {255, 0, 0, 0}};
+const ParticleEmitter POWER_LOST_EFFECT = {15, 4.0f, 0.0f, 1.0f, GameConstants::PARTICLE_LIFETIME, 3.0f,
+                                           {0, 191, 255, 255}, {0, 191, 255, 0}}; // Blue/Magic particles
+const ParticleEmitter PICKUP_EFFECT = {GameConstants::COLLECT_PARTICLE_COUNT, 4.0f, 0.0f, 1.0f,
+                                       GameConstants::PARTICLE_LIFETIME, 3.0f, {255, 215, 0, 255}, {255, 215, 0, 0}};
+const ParticleEmitter CLASH_EFFECT = {20, 4.0f, 0.0f, 1.0f, GameConstants::PARTICLE_LIFETIME, 3.0f,
+                                      {255, 255, 255, 255}, {255, 255, 255, 0}};
+const ParticleEmitter MUZZLE_EFFECT = {5, 4.0f, 0.0f, 1.0f, GameConstants::PARTICLE_LIFETIME, 3.0f,
+                                       {255, 69, 0, 255}, {255, 69, 0, 0}}; // Small muzzle puff
+const ParticleEmitter CHARGE_EFFECT = {10, 4.0f, 0.0f, 1.0f, GameConstants::PARTICLE_LIFETIME, 3.0f,
+                                       {255, 255, 255, 255}, {255, 255, 255, 0}}; // Tinted per player
+
+// Projectile sweeps per job (matches rarely have more than a few dozen)
+const int PROJECTILES_PER_JOB = 32;
+
+// Effects further than this off screen are not emitted (nobody would see them)
+const float EFFECT_VIEW_MARGIN = 100.0f;
+
+// Entities a snapshot has room for (the first ones by index)
+const int SNAPSHOT_PROJECTILES = static_cast<int>(sizeof(Packet::projectiles) / sizeof(Packet::projectiles[0]));
+const int SNAPSHOT_POWER_UPS = static_cast<int>(sizeof(Packet::powerUps) / sizeof(Packet::powerUps[0]));
+
+// Local keyboard layouts, by player index (players beyond these have no keys)
+struct KeyLayout {
+    SDL_Keycode left, right, jump, down, attack;
+};
+const KeyLayout KEY_LAYOUTS[] = {
+    {SDLK_a, SDLK_d, SDLK_w, SDLK_s, SDLK_f},                // P1: WASD + F
+    {SDLK_LEFT, SDLK_RIGHT, SDLK_UP, SDLK_DOWN, SDLK_RETURN}, // P2: Arrows + Enter
+    {SDLK_j, SDLK_l, SDLK_i, SDLK_k, SDLK_u},                // P3: IJKL + U
+    {SDLK_KP_4, SDLK_KP_6, SDLK_KP_8, SDLK_KP_5, SDLK_KP_0}   // P4: Numpad 4/6/8/5 + 0
+};
+const int NUM_KEY_LAYOUTS = sizeof(KEY_LAYOUTS) / sizeof(KEY_LAYOUTS[0]);
+
+// Sprite tints for players 3 and up (P1 and P2 are told apart by character)
+const SDL_Color EXTRA_PLAYER_TINTS[] = {
+    {255, 160, 160, 255}, {160, 200, 255, 255}, {255, 230, 140, 255},
+    {170, 255, 170, 255}, {230, 160, 255, 255}, {255, 200, 120, 255}
+};
+
+void applyKey(Player& p, const KeyLayout& k, SDL_Keycode sym, bool down) {
+    if (sym == k.left) p.keyLeft = down;
+    if (sym == k.right) p.keyRight = down;
+    if (sym == k.jump) p.keyJump = down;
+    if (sym == k.down) p.keyDown = down;
+    if (sym == k.attack) p.keyAttack = down;
+}
+
+void writeNetPlayer(NetPlayer& n, const Player& p) {
+    n.x = p.x; n.y = p.y;
+    n.vx = p.vx; n.vy = p.vy;
+    n.hp = static_cast<Sint16>(p.hp);
+    n.power = p.power;
+    n.powerTimer = static_cast<Sint16>(p.powerTimer);
+    n.invincible = static_cast<Sint16>(p.invincible);
+    n.attackCooldown = static_cast<Sint16>(p.attackCooldown);
+    n.flags = (p.facing == -1 ? NetPlayer::FLAG_FACING_LEFT : 0) | (p.onGround ? NetPlayer::FLAG_ON_GROUND : 0);
+}
+
+void readNetPlayer(const NetPlayer& n, Player& p) {
+    p.x = n.x; p.y = n.y;
+    p.vx = n.vx; p.vy = n.vy;
+    p.hp = n.hp;
+    p.power = static_cast<PowerType>(n.power);
+    p.powerTimer = n.powerTimer;
+    p.invincible = n.invincible;
+    p.attackCooldown = n.attackCooldown;
+    p.facing = (n.flags & NetPlayer::FLAG_FACING_LEFT) ? -1 : 1;
+    p.onGround = (n.flags & NetPlayer::FLAG_ON_GROUND) != 0;
+}
+}
+
 Game::Game() : window(nullptr), renderer(nullptr), font(nullptr), titleFont(nullptr),
              boyTexture(nullptr), girlTexture(nullptr), boyDragonTexture(nullptr), girlDragonTexture(nullptr),
     boyRhinoTexture(nullptr), girlRhinoTexture(nullptr), backgroundTexture(nullptr),
@@ -13,8 +91,8 @@ Game::Game() : window(nullptr), renderer(nullptr), font(nullptr), titleFont(null
              bgGreenTexture(nullptr), bgSnowTexture(nullptr),
              tileGreenTexture(NULL), tileSnowTexture(NULL),
              currentSeason(SEASON_GREEN), // Default Season
-             currentState(MENU), running(true), p1Character(0), p2Character(1), lastPowerUpTime(0),
-             gameTime(GameConstants::GAME_DURATION) {}
+             currentState(MENU), running(true), p1Character(0), p2Character(1),
+             gameTicks(GameConstants::GAME_DURATION_TICKS), powerUpSpawnTicks(0) {}
 
 Game::~Game() {
     cleanup();
@@ -43,14 +121,28 @@ bool Game::init() {
         GameConstants::WINDOW_WIDTH, GameConstants::WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
     if (!window) return false;
 
-    // Create the renderer (hardware accelerated, vsync enabled)
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    // Create the renderer (hardware accelerated, vsync unless another pacing mode was asked for)
+    pacer.configureFromEnvironment();
+    Uint32 rendererFlags = SDL_RENDERER_ACCELERATED | (pacer.wantsVsync() ? SDL_RENDERER_PRESENTVSYNC : 0);
+    renderer = SDL_CreateRenderer(window, -1, rendererFlags);
     if (!renderer) {
         std::cerr << "Accelerated Init Failed (" << SDL_GetError() << "). Trying Software Renderer..." << std::endl;
         renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
     }
     if (!renderer) return false;
 
+    // Tell the pacer what we actually got
+    SDL_RendererInfo info;
+    bool vsync = SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+    SDL_DisplayMode displayMode;
+    int displayHz = SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(window), &displayMode) == 0
+                        ? displayMode.refresh_rate : 0;
+    pacer.start(vsync, displayHz);
+
+    // Worker threads: AMPHITUDE_THREADS=N extra threads (0 = all on this one), default one per spare core
+    const char* threadsEnv = getenv("AMPHITUDE_THREADS");
+    jobs.start(threadsEnv && *threadsEnv ? std::max(0, atoi(threadsEnv)) : -1);
+
     loadAssets();
     initGameObjects();
 
@@ -64,25 +156,101 @@ bool Game::init() {
 
 void Game::run() {
     SDL_Event event;
+
+    // Fixed Timestep: real time goes into an accumulator that is spent in whole ticks
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 tickLength = frequency / GameConstants::TICK_RATE;
+    const Uint64 maxCatchUp = frequency * GameConstants::MAX_CATCHUP_MS / 1000;
+    Uint64 accumulator = 0;
+    Uint64 previous = SDL_GetPerformanceCounter();
+
     // Main Game Loop using for(;;) as requested for industry standard flow
     for (; running; ) {
-        Uint32 frameStart = SDL_GetTicks();
+        // Wait first, so input is read as late as possible before the frame is shown
+        pacer.waitForNextFrame();
+
+        Uint64 now = SDL_GetPerformanceCounter();
+        // A long stall (window drag, breakpoint) is dropped rather than fast-forwarded
+        accumulator += std::min(now - previous, maxCatchUp);
+        previous = now;
         // UDP Handshake is handled in update/receive
         // if (isOnline && !net.connected) { ... }
 
         handleEvents(event); // 1. Input
-        update();            // 2. Logic
-        render();            // 3. Draw
-        
-        // Frame Capping: Wait if the frame finished too quickly
-        Uint32 frameTime = SDL_GetTicks() - frameStart;
-        if (GameConstants::FRAME_DELAY > frameTime) {
-            SDL_Delay(GameConstants::FRAME_DELAY - frameTime);
+
+        // 2. Logic: zero or more ticks, however long this frame took
+        for (; accumulator >= tickLength; accumulator -= tickLength) {
+            storePreviousPositions();
+            update();
         }
+
+        // 3. Draw, part way between the last two ticks
+        renderAlpha = static_cast<float>(accumulator) / static_cast<float>(tickLength);
+        render();
+        pacer.framePresented();
     }
+
+    pacer.logStats();
+}
+
+void Game::storePreviousPositions() {
+    for (auto& player : players) { player.prevX = player.x; player.prevY = player.y; }
+    projectiles.storePrevious();
+    powerUps.storePrevious();
+    particles.storePrevious();
+    camera.prevX = camera.x;
+    camera.prevY = camera.y;
+}
+
+void Game::followCamera(bool snap) {
+    float cx = 0, cy = 0;
+    int alive = 0;
+    for (const Player& p : players) {
+        if (p.hp <= 0) continue;
+        cx += p.x + p.width / 2; cy += p.y + p.height / 2;
+        alive++;
+    }
+    if (alive > 0) { cx /= alive; cy /= alive; }
+    else { cx = level.width() / 2; cy = level.height() / 2; }
+
+    if (snap) camera.snap(cx, cy, level.width(), level.height());
+    else camera.follow(cx, cy, level.width(), level.height());
+
+    // Effects only live around the view
+    particles.setActiveArea(camera.x - EFFECT_VIEW_MARGIN, camera.y - EFFECT_VIEW_MARGIN,
+                            camera.width + 2 * EFFECT_VIEW_MARGIN, camera.height + 2 * EFFECT_VIEW_MARGIN);
 }
 
 void Game::loadAssets() {
+    // Decode the images on the worker threads while the fonts load here
+    // (textures themselves can only be created on this thread)
+    struct ImageAsset {
+        const char* path;
+        SDL_Texture** texture;
+        int* w;
+        int* h;
+        SDL_Surface* surface;
+    };
+    ImageAsset images[] = {
+        // Characters
+        {"assets/Indian boy comp.png", &boyTexture, &boyW, &boyH, nullptr},
+        {"assets/Indian girl comp.png", &girlTexture, &girlW, &girlH, nullptr},
+        {"assets/Indian boy dragon.png", &boyDragonTexture, nullptr, nullptr, nullptr},
+        {"assets/Indian girl dragon.png", &girlDragonTexture, nullptr, nullptr, nullptr},
+        {"assets/Indian boy rhino.png", &boyRhinoTexture, nullptr, nullptr, nullptr},
+        {"assets/Indian girl rhino.png", &girlRhinoTexture, nullptr, nullptr, nullptr},
+        // Environment (Green)
+        {"assets/Background Green.png", &bgGreenTexture, nullptr, nullptr, nullptr},
+        {"assets/Mud Tile.png", &tileGreenTexture, nullptr, nullptr, nullptr},
+        // Environment (Snow)
+        {"assets/Background Snow.png", &bgSnowTexture, nullptr, nullptr, nullptr},
+        {"assets/Mud Tile Snow.png", &tileSnowTexture, nullptr, nullptr, nullptr}
+    };
+    JobGroup decoding;
+    for (ImageAsset& img : images) {
+        jobs.run(decoding, [&img] { img.surface = IMG_Load(img.path); });
+    }
+
     // Attempt to load fonts from common system paths
     const char* fontPaths[] = {
         "assets/PressStart2P-Regular.ttf",
@@ -95,62 +263,12 @@ void Game::loadAssets() {
     for (int i = 0; fontPaths[i] != nullptr && !font; ++i) font = TTF_OpenFont(fontPaths[i], 16); // Smaller size for retro font
     for (int i = 0; fontPaths[i] != nullptr && !titleFont; ++i) titleFont = TTF_OpenFont(fontPaths[i], 64); // Large Banner Font
 
-    // Load Character Textures
-    SDL_Surface* surf = IMG_Load("assets/Indian boy comp.png");
-    if (surf) {
-        boyTexture = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_QueryTexture(boyTexture, NULL, NULL, &boyW, &boyH);
-        SDL_FreeSurface(surf);
-    }
-    surf = IMG_Load("assets/Indian girl comp.png");
-    if (surf) {
-        girlTexture = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_QueryTexture(girlTexture, NULL, NULL, &girlW, &girlH);
-        SDL_FreeSurface(surf);
-    }
-    surf = IMG_Load("assets/Indian boy dragon.png");
-    if (surf) {
-        boyDragonTexture = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_FreeSurface(surf);
-    }
-    surf = IMG_Load("assets/Indian girl dragon.png");
-    if (surf) {
-        girlDragonTexture = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_FreeSurface(surf);
-    }
-    surf = IMG_Load("assets/Indian boy rhino.png");
-    if (surf) {
-        boyRhinoTexture = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_FreeSurface(surf);
-    }
-    surf = IMG_Load("assets/Indian girl rhino.png");
-    if (surf) {
-        girlRhinoTexture = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_FreeSurface(surf);
-    }
-
-    // Load Environment (Green)
-    surf = IMG_Load("assets/Background Green.png");
-    if (surf) {
-        bgGreenTexture = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_FreeSurface(surf);
-    }
-    surf = IMG_Load("assets/Mud Tile.png");
-    if (surf) {
-        tileGreenTexture = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_FreeSurface(surf);
-    }
-
-    // Load Environment (Snow)
-    surf = IMG_Load("assets/Background Snow.png");
-    if (surf) {
-        bgSnowTexture = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_FreeSurface(surf);
-    }
-    surf = IMG_Load("assets/Mud Tile Snow.png");
-    if (surf) {
-        tileSnowTexture = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_FreeSurface(surf);
+    jobs.wait(decoding);
+    for (ImageAsset& img : images) {
+        if (!img.surface) continue;
+        *img.texture = SDL_CreateTextureFromSurface(renderer, img.surface);
+        if (img.w) SDL_QueryTexture(*img.texture, NULL, NULL, img.w, img.h);
+        SDL_FreeSurface(img.surface);
     }
 
     // Set Initial Defaults
@@ -161,19 +279,71 @@ void Game::loadAssets() {
 }
 
 void Game::initGameObjects() {
-    // Define static platforms
-    platforms = {
-        {0, 500, 800, 20},   // Ground
-        {150, 400, 150, 15}, // Left low
-        {500, 400, 150, 15}, // Right low
-        {325, 300, 150, 15}, // Middle high
-        {50, 250, 120, 15},  // Left high
-        {630, 250, 120, 15}  // Right high
-    };
-    players.resize(2);
+    // Arena: AMPHITUDE_LEVEL=path/to/file.lvl, else the bundled one, else built in
+    const char* levelPath = getenv("AMPHITUDE_LEVEL");
+    if (!levelPath || !*levelPath) levelPath = "assets/levels/classic.lvl";
+    Uint64 loadStart = SDL_GetPerformanceCounter();
+    if (level.load(levelPath)) {
+        levelFile = levelPath;
+        double ms = (SDL_GetPerformanceCounter() - loadStart) * 1000.0 / SDL_GetPerformanceFrequency();
+        std::cout << "Level: " << level.name() << " (" << levelPath << ", " << ms << " ms)" << std::endl;
+    } else {
+        std::cout << "Level: " << levelPath << " not loaded, using the built-in arena" << std::endl;
+        level.loadDefault();
+    }
+
+    // Local matches: AMPHITUDE_PLAYERS=2..MAX_PLAYERS (online is always two peers)
+    const char* playersEnv = getenv("AMPHITUDE_PLAYERS");
+    if (playersEnv && *playersEnv) {
+        localPlayers = std::max(2, std::min(GameConstants::MAX_PLAYERS, atoi(playersEnv)));
+    }
+    // Reproducible local matches: AMPHITUDE_SEED=N
+    const char* seedEnv = getenv("AMPHITUDE_SEED");
+    if (seedEnv && *seedEnv) fixedSeed = static_cast<Uint32>(strtoul(seedEnv, nullptr, 10));
+
+    initSimulation();
     spawnPowerUps();
 }
 
+void Game::initSimulation() {
+    players.resize(2);
+    for (size_t i = 0; i < PLAYER_LANES; ++i) packPlayerBox(i);
+
+    // Entity columns are sized once; the per-tick loops never allocate
+    projectiles.reserve(GameConstants::MAX_PROJECTILES);
+    projectileHits.reserve(GameConstants::MAX_PROJECTILES);
+    scratchProjectiles.reserve(GameConstants::MAX_PROJECTILES);
+    powerUps.reserve(GameConstants::MAX_POWER_UPS);
+}
+
+bool Game::initHeadless(int numPlayers, const char* levelPath) {
+    headless = true;
+    localPlayers = std::max(2, std::min(GameConstants::MAX_PLAYERS, numPlayers));
+    if (levelPath) {
+        if (!level.load(levelPath)) return false;
+        levelFile = levelPath;
+    } else {
+        level.loadDefault();
+    }
+    initSimulation();
+    return true;
+}
+
+void Game::startMatch(Uint32 seed) {
+    isOnline = false;
+    matchSeed = seed;
+    resetGame();
+    currentState = PLAYING;
+}
+
+void Game::startOnlineMatch(Uint32 seed, bool host) {
+    isOnline = true;
+    net.isHost = host;
+    matchSeed = seed;
+    resetGame();
+    currentState = PLAYING;
+}
+
 void Game::resetGame() {
     // Determine texture based on selection
     SDL_Texture* p1Tex = (p1Character == 0) ? boyTexture : girlTexture;
@@ -197,9 +367,32 @@ void Game::resetGame() {
     if (p2FinalName.empty()) p2FinalName = (p2Character == 0) ? "Xeno" : "Zeni";
 
     // Initialize players
-    // P1 starts on left, P2 on right
-    players[0].init(1, 100, 400, {255, 255, 255, 255}, p1FinalName, p1Tex, p1DragonTex, p1RhinoTex, p1W/6, p1H/3, 6, 3);
-    players[1].init(2, 700, 400, {255, 255, 255, 255}, p2FinalName, p2Tex, p2DragonTex, p2RhinoTex, p2W/6, p2H/3, 6, 3);
+    // At the level's start points (P1 left, P2 right if the level has none)
+    int count = isOnline ? 2 : localPlayers;
+    players.resize(count);
+    float p1X = 100, p1Y = 400, p2X = 700, p2Y = 400;
+    level.spawnPoint(0, LevelFormat::SPAWN_START, p1X, p1Y);
+    level.spawnPoint(1, LevelFormat::SPAWN_START, p2X, p2Y);
+    players[0].init(1, p1X, p1Y, {255, 255, 255, 255}, p1FinalName, p1Tex, p1DragonTex, p1RhinoTex, p1W/6, p1H/3, 6, 3);
+    players[1].init(2, p2X, p2Y, {255, 255, 255, 255}, p2FinalName, p2Tex, p2DragonTex, p2RhinoTex, p2W/6, p2H/3, 6, 3);
+
+    // Extra local players alternate characters, each with its own tint
+    for (int i = 2; i < count; ++i) {
+        bool boy = (i % 2 == 0);
+        float x = level.width() * (i + 1) / (count + 1), y = 400;
+        level.spawnPoint(i, LevelFormat::SPAWN_START, x, y);
+        players[i].init(i + 1, x, y, EXTRA_PLAYER_TINTS[(i - 2) % 6], "P" + std::to_string(i + 1),
+                        boy ? boyTexture : girlTexture, boy ? boyDragonTexture : girlDragonTexture,
+                        boy ? boyRhinoTexture : girlRhinoTexture,
+                        (boy ? boyW : girlW) / 6, (boy ? boyH : girlH) / 3, 6, 3);
+    }
+
+    // Fresh random streams. Local matches pick their own seed; online peers
+    // (host's start packet) and headless runs set matchSeed beforehand.
+    if (!isOnline && !headless) matchSeed = fixedSeed ? fixedSeed : Random::entropySeed();
+    gameplayRng.seed(matchSeed, STREAM_GAMEPLAY);
+    cosmeticRng.seed(matchSeed, STREAM_COSMETIC);
+    powerUpSpawns = 0;
 
     // Clear dynamic objects
     projectiles.clear();
@@ -208,14 +401,499 @@ void Game::resetGame() {
     
     // Initial Spawn
     spawnPowerUps();
-    lastPowerUpTime = SDL_GetTicks();
+    powerUpSpawnTicks = GameConstants::POWER_UP_SPAWN_TICKS;
     
-    gameTime = GameConstants::GAME_DURATION;
+    gameTicks = GameConstants::GAME_DURATION_TICKS;
     winnerId = 0;
+
+    // Fresh event stream
+    simTick = 0;
+    frameEvents.clear();
+    outgoingEvents.clear();
+    nextEventSeq = 0;
+    lastEventSeq = 0;
+
+    // Fresh input timeline for prediction / host input buffer
+    localInputTick = 0;
+    lastAckedInputTick = 0;
+    remoteInputNewest = 0;
+    remoteInputApplied = 0;
+    for (int i = 0; i < INPUT_HISTORY_SIZE; ++i) {
+        inputHistory[i].tick = 0;
+        remoteInputTicks[i] = 0;
+    }
+    desync.reset();
+    worldDumped = false;
+    followCamera(true); // Start looking at the players, not panning over to them
+
+    // CPU players: everyone but P1 in a VS CPU match (the search has its own copy of the arena).
+    // Kept between matches unless the roster, difficulty or arena changed.
+    bool botsCurrent = bots.size() == static_cast<size_t>(count - 1);
+    for (size_t i = 0; i < bots.size() && botsCurrent; ++i) {
+        botsCurrent = bots[i]->difficulty() == botDifficulty && bots[i]->levelPath() == levelFile;
+    }
+    if (isOnline || !vsCpu) {
+        bots.clear();
+    } else if (!botsCurrent) {
+        bots.clear();
+        const char* botThreadEnv = getenv("AMPHITUDE_BOT_THREAD"); // 0 = search on the main thread
+        bool async = !(botThreadEnv && *botThreadEnv && atoi(botThreadEnv) == 0);
+        for (int i = 1; i < count; ++i) {
+            bots.emplace_back(new Bot(i, count, botDifficulty, levelFile.empty() ? nullptr : levelFile.c_str(),
+                                      &jobs, async));
+        }
+    } else {
+        for (auto& bot : bots) bot->reset();
+    }
+    for (auto& bot : bots) players[bot->playerIndex()].name = "CPU";
+}
+
+void Game::processEvents() {
+    if (isOnline && !net.isHost) {
+        // Client: our simulation is only a guess; the host's events drive the effects
+        frameEvents.clear();
+        return;
+    }
+
+    for (auto& e : frameEvents) {
+        e.seq = ++nextEventSeq;
+        if (e.seq == 0) e.seq = ++nextEventSeq; // 0 means "unassigned"
+        e.tick = static_cast<Uint16>(simTick);
+        e.seed = static_cast<Uint16>(cosmeticRng.next());
+        if (!headless) playEvent(e);
+        if (isOnline) outgoingEvents.push_back({e, 0});
+    }
+    frameEvents.clear();
+}
+
+void Game::playEvent(const GameEvent& e) {
+    float x = e.x, y = e.y;
+    if (!camera.sees(x, y, 0, 0, EFFECT_VIEW_MARGIN)) return;
+    switch (e.type) {
+        case GameEvent::HIT:
+            particles.emit(HIT_EFFECT, x, y, e.seed);
+            break;
+        case GameEvent::POWER_LOST:
+            particles.emit(POWER_LOST_EFFECT, x, y, e.seed);
+            break;
+        case GameEvent::PICKUP:
+            particles.emit(PICKUP_EFFECT, x, y, e.seed);
+            break;
+        case GameEvent::CLASH:
+            particles.emit(CLASH_EFFECT, x, y, e.seed);
+            break;
+        case GameEvent::PROJECTILE_SPAWN:
+            particles.emit(MUZZLE_EFFECT, x, y, e.seed);
+            break;
+        case GameEvent::CHARGE:
+            if (e.arg < players.size()) {
+                ParticleEmitter charge = CHARGE_EFFECT;
+                charge.startColor = players[e.arg].color;
+                charge.endColor = {charge.startColor.r, charge.startColor.g, charge.startColor.b, 0};
+                particles.emit(charge, x, y, e.seed);
+            }
+            break;
+    }
+}
+
+void Game::writeEvents(Packet& p) {
+    // Send each event a few times so a lost packet doesn't lose the effect
+    const Uint8 EVENT_RESEND_COUNT = 3;
+    p.numEvents = 0;
+    for (auto& out : outgoingEvents) {
+        if (p.numEvents >= 8) break;
+        p.events[p.numEvents++] = out.event;
+        out.timesSent++;
+    }
+    outgoingEvents.erase(std::remove_if(outgoingEvents.begin(), outgoingEvents.end(),
+        [EVENT_RESEND_COUNT](const OutgoingEvent& o) { return o.timesSent >= EVENT_RESEND_COUNT; }),
+        outgoingEvents.end());
+}
+
+void Game::readEvents(const Packet& p) {
+    for (int i = 0; i < p.numEvents && i < 8; ++i) {
+        const GameEvent& e = p.events[i];
+        // Wrap-safe "newer than": duplicates and reordered repeats are skipped
+        if (static_cast<Sint16>(e.seq - lastEventSeq) <= 0) continue;
+        lastEventSeq = e.seq;
+        playEvent(e);
+    }
+}
+
+bool Game::isLocalPlayer(size_t i) const {
+    if (!isOnline) return true;
+    return i == (net.isHost ? 0u : 1u);
+}
+
+void Game::queueRemoteInput(const Packet& p) {
+    // Each packet carries the last 8 inputs; fill any gaps left by lost packets
+    for (Uint32 k = 0; k < 8 && k < p.inputTick; ++k) {
+        Uint32 tick = p.inputTick - k;
+        if (tick <= remoteInputApplied) break;
+        remoteInputs[tick % INPUT_HISTORY_SIZE] = p.inputHistory[k];
+        remoteInputTicks[tick % INPUT_HISTORY_SIZE] = tick;
+    }
+    if (p.inputTick > remoteInputNewest) remoteInputNewest = p.inputTick;
+}
+
+void Game::applyNextRemoteInput() {
+    if (remoteInputNewest <= remoteInputApplied) return; // Starved: keep the last keys
+
+    // Don't let a backlog (client running fast, burst after a stall) turn into input delay
+    const Uint32 MAX_INPUT_BACKLOG = 4;
+    if (remoteInputNewest - remoteInputApplied > MAX_INPUT_BACKLOG) {
+        remoteInputApplied = remoteInputNewest - MAX_INPUT_BACKLOG;
+    }
+
+    remoteInputApplied++;
+    Uint32 slot = remoteInputApplied % INPUT_HISTORY_SIZE;
+    if (remoteInputTicks[slot] == remoteInputApplied) {
+        players[1].setInputBits(remoteInputs[slot]);
+    }
+    // else: lost even with redundancy, repeat the previous keys
+}
+
+void Game::reconcileLocalPlayer(const Packet& s) {
+    Player& me = players[1];
+
+    // Ignore reordered (older) snapshots
+    if (s.ackInputTick < lastAckedInputTick || s.ackInputTick > localInputTick) return;
+    lastAckedInputTick = s.ackInputTick;
+
+    // Non-predicted state always comes straight from the host
+    const NetPlayer& auth = s.players[1];
+    me.hp = auth.hp;
+
+    // Prediction Check: if we predicted the acknowledged tick exactly, nothing to fix
+    const PredictedFrame& predicted = inputHistory[s.ackInputTick % INPUT_HISTORY_SIZE];
+    bool historyValid = predicted.tick == s.ackInputTick && s.ackInputTick > 0 &&
+                        localInputTick - s.ackInputTick < INPUT_HISTORY_SIZE;
+    if (historyValid &&
+        std::abs(predicted.x - auth.x) < 0.01f && std::abs(predicted.y - auth.y) < 0.01f &&
+        std::abs(predicted.vx - auth.vx) < 0.01f && std::abs(predicted.vy - auth.vy) < 0.01f &&
+        predicted.onGround == ((auth.flags & NetPlayer::FLAG_ON_GROUND) != 0) &&
+        me.power == auth.power) {
+        return;
+    }
+
+    // Where we are currently drawn, before correcting
+    float shownX = me.x + me.renderOffsetX;
+    float shownY = me.y + me.renderOffsetY;
+
+    // 1. Rewind to the authoritative state for the acknowledged tick
+    readNetPlayer(auth, me);
+
+    // 2. Replay every input the host hasn't seen yet (the current tick runs in the normal update)
+    if (historyValid || s.ackInputTick == 0) {
+        int savedFrame = me.currentFrame, savedTimer = me.frameTimer, savedRow = me.animRow;
+        Uint8 liveInput = me.getInputBits();
+        for (Uint32 t = s.ackInputTick + 1; t < localInputTick; ++t) {
+            PredictedFrame& frame = inputHistory[t % INPUT_HISTORY_SIZE];
+            me.setInputBits(frame.input);
+            // Replays must not spawn real projectiles/effects; the host sends those
+            scratchProjectiles.clear();
+            scratchEvents.clear();
+            me.update(level, scratchProjectiles, scratchEvents);
+            frame.x = me.x; frame.y = me.y;
+            frame.vx = me.vx; frame.vy = me.vy;
+            frame.onGround = me.onGround;
+        }
+        me.setInputBits(liveInput);
+        me.currentFrame = savedFrame; me.frameTimer = savedTimer; me.animRow = savedRow;
+    }
+
+    // 3. Visual Smoothing: keep drawing where we were and glide to the corrected spot.
+    // Big jumps (respawn) snap instead.
+    me.renderOffsetX = shownX - me.x;
+    me.renderOffsetY = shownY - me.y;
+    if (std::abs(me.renderOffsetX) > 64 || std::abs(me.renderOffsetY) > 64) {
+        me.renderOffsetX = 0;
+        me.renderOffsetY = 0;
+    }
 }
 
 void Game::spawnPowerUps() {
-    spawnPowerUp(powerUps, platforms);
+    if (isOnline && !net.isHost) return; // The client replays the host's spawns (syncPowerUps)
+    if (powerUps.size() >= GameConstants::MAX_POWER_UPS || !level.hasPowerUpZones()) return;
+    PowerUpSpawn spawn = rollPowerUp(level, gameplayRng);
+    ++powerUpSpawns;
+    addPowerUp(spawn);
+}
+
+void Game::addPowerUp(const PowerUpSpawn& spawn) {
+    size_t i = powerUps.add(spawn.x, spawn.y, GameConstants::POWER_UP_SIZE, GameConstants::POWER_UP_SIZE, spawn.type);
+    powerUps.life[i] = GameConstants::POWER_UP_LIFETIME;
+    powerUps.netId[i] = static_cast<Uint16>(powerUpSpawns);
+}
+
+void Game::syncPowerUps(const Packet& s) {
+    auto listed = [&s](Uint16 id) -> const NetPowerUp* {
+        for (int k = 0; k < s.numPowerUps && k < 5; ++k) {
+            if (s.powerUps[k].id == id) return &s.powerUps[k];
+        }
+        return nullptr;
+    };
+
+    // Picked up or expired on the host (swap-and-pop: stay on index i after removing)
+    for (size_t i = 0; i < powerUps.size(); ) {
+        if (listed(powerUps.netId[i])) ++i;
+        else powerUps.remove(i);
+    }
+
+    // Roll every spawn the host made since our last snapshot, in order, so the
+    // stream stays in step; add the ones that are still there
+    Uint32 behind = s.powerUpSpawns - powerUpSpawns;
+    if (behind > 1000) return; // Not this match's numbering
+    for (; powerUpSpawns != s.powerUpSpawns; ) {
+        PowerUpSpawn spawn = rollPowerUp(level, gameplayRng);
+        ++powerUpSpawns;
+        if (listed(static_cast<Uint16>(powerUpSpawns))) addPowerUp(spawn);
+    }
+
+    // Remaining lifetime is the host's
+    for (size_t i = 0; i < powerUps.size(); ++i) {
+        powerUps.life[i] = listed(powerUps.netId[i])->lifetime;
+        powerUps.timer[i] = GameConstants::POWER_UP_LIFETIME - powerUps.life[i];
+    }
+}
+
+void Game::writeSnapshot(Packet& s) const {
+    s.type = 2; // Game State
+    s.gameTicks = gameTicks;
+    s.hostTick = simTick;
+    // This state is the result of the last frame's update, i.e. of remoteInputApplied
+    s.ackInputTick = remoteInputApplied;
+
+    s.numPlayers = static_cast<Uint8>(players.size());
+    for (size_t i = 0; i < players.size(); ++i) writeNetPlayer(s.players[i], players[i]);
+
+    // Sync PowerUps
+    s.matchSeed = matchSeed;
+    s.levelChecksum = level.checksum();
+    s.powerUpSpawns = powerUpSpawns;
+    s.numPowerUps = 0;
+    for (size_t i = 0; i < powerUps.size() && s.numPowerUps < SNAPSHOT_POWER_UPS; ++i) {
+        NetPowerUp& n = s.powerUps[s.numPowerUps++];
+        n.id = powerUps.netId[i];
+        n.lifetime = static_cast<Uint16>(std::max(0, powerUps.life[i]));
+    }
+
+    // Sync Projectiles
+    s.numProjectiles = 0;
+    for (size_t i = 0; i < projectiles.size() && s.numProjectiles < SNAPSHOT_PROJECTILES; ++i) {
+        Packet::NetProjectile& n = s.projectiles[s.numProjectiles++];
+        n.id = projectiles.netId[i];
+        n.x = projectiles.x[i];
+        n.y = projectiles.y[i];
+        n.vx = projectiles.vx[i];
+        n.vy = projectiles.vy[i];
+        n.owner = projectiles.owner[i];
+        n.type = projectiles.type[i];
+    }
+
+    // Sync Game State (Game Over)
+    s.gameState = currentState;
+    if (currentState == GAMEOVER) s.winnerId = decideWinner();
+}
+
+void Game::finishSnapshot(Packet& s) {
+    writeEvents(s);
+    desync.fillReport(s.checksums);
+}
+
+bool Game::applySnapshot(const Packet& s) {
+    // Apply Host State (everyone but us)
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (i != 1) readNetPlayer(s.players[i], players[i]);
+    }
+
+    // Our own player is predicted locally, so reconcile instead of overwriting
+    reconcileLocalPlayer(s);
+
+    // Sync Game Time
+    gameTicks = s.gameTicks;
+
+    // Effects happen where the host says they happened
+    readEvents(s);
+
+    // Sync PowerUps (rolled locally from the shared stream, the host says which remain)
+    syncPowerUps(s);
+
+    // Sync Projectiles
+    applyReplicated(projectiles, s.projectiles, s.numProjectiles,
+        [](EntityStore& proj, size_t i, const Packet::NetProjectile& n, bool created) {
+            if (created) {
+                proj.prevX[i] = n.x;
+                proj.prevY[i] = n.y;
+                proj.w[i] = GameConstants::PROJECTILE_SIZE;
+                proj.h[i] = GameConstants::PROJECTILE_SIZE;
+                proj.owner[i] = static_cast<Sint8>(n.owner);
+                proj.type[i] = n.type;
+            }
+            proj.x[i] = n.x;
+            proj.y[i] = n.y;
+            proj.vx[i] = n.vx;
+            proj.vy[i] = n.vy;
+        });
+
+    // Sync Game State
+    if (s.gameState == GAMEOVER) {
+        currentState = GAMEOVER;
+        winnerId = s.winnerId;
+    }
+
+    // Our world now stands for the host's tick: digest it under that tick, then
+    // compare with what the host reported (older snapshots' digests included)
+    if (s.hostTick == 0) return true;
+    WorldDigest digest;
+    captureDigest(digest, s.hostTick);
+    desync.record(digest);
+    return desync.check(s.checksums, "host");
+}
+
+bool Game::samePeerLevel(const Packet& p) {
+    if (p.levelChecksum == level.checksum()) return true;
+    std::cout << "Peer's arena differs (checksum " << std::hex << p.levelChecksum << ", ours "
+              << level.checksum() << std::dec << "), leaving" << std::endl;
+    isOnline = false;
+    currentState = MENU;
+    net.disconnect();
+    p1Ready = false;
+    p2Ready = false;
+    waitingForCode = false;
+    enteringCode = false;
+    secretCode = "";
+    connectionFailed = false;
+    signalingError = std::string("Peer has a different arena file (ours: ") + level.name() + ")";
+    return false;
+}
+
+Uint16 Game::allocNetId() {
+    if (++nextNetId == 0) nextNetId = 1; // 0 means "unassigned"
+    return nextNetId;
+}
+
+void Game::assignNetIds() {
+    // Only the authority hands out IDs; the client takes them from snapshots
+    if (isOnline && !net.isHost) return;
+    for (auto& id : projectiles.netId) if (id == 0) id = allocNetId();
+}
+
+bool Game::saveWorld(WorldState& w) const {
+    if (players.size() > static_cast<size_t>(GameConstants::MAX_PLAYERS)) return false;
+    memset(static_cast<void*>(&w), 0, sizeof(w)); // Unused slots stay zero, so equal worlds hash equal
+    w.simTick = simTick;
+    w.gameTicks = gameTicks;
+    w.powerUpSpawnTicks = powerUpSpawnTicks;
+    w.winnerId = winnerId;
+    w.matchSeed = matchSeed;
+    w.powerUpSpawns = powerUpSpawns;
+    w.gameplayRng = gameplayRng;
+    w.cosmeticRng = cosmeticRng;
+    w.nextNetId = nextNetId;
+    w.gameState = static_cast<Uint8>(currentState);
+    w.numPlayers = static_cast<Uint8>(players.size());
+    for (size_t i = 0; i < players.size(); ++i) {
+        memcpy(&w.players[i], static_cast<const PlayerState*>(&players[i]), sizeof(PlayerState));
+    }
+    return projectiles.save(w.projectiles) && powerUps.save(w.powerUps);
+}
+
+void Game::restoreWorld(const WorldState& w) {
+    simTick = w.simTick;
+    gameTicks = w.gameTicks;
+    powerUpSpawnTicks = w.powerUpSpawnTicks;
+    winnerId = w.winnerId;
+    matchSeed = w.matchSeed;
+    powerUpSpawns = w.powerUpSpawns;
+    gameplayRng = w.gameplayRng;
+    cosmeticRng = w.cosmeticRng;
+    nextNetId = w.nextNetId;
+    currentState = static_cast<GameState>(w.gameState);
+    players.resize(w.numPlayers);
+    for (size_t i = 0; i < players.size(); ++i) {
+        memcpy(static_cast<PlayerState*>(&players[i]), &w.players[i], sizeof(PlayerState));
+        players[i].selectTexture();
+        players[i].renderOffsetX = players[i].renderOffsetY = 0;
+    }
+    projectiles.restore(w.projectiles);
+    powerUps.restore(w.powerUps);
+}
+
+void Game::dumpWorld(const char* reason) const {
+    WorldState w;
+    if (!saveWorld(w)) return;
+    std::vector<Uint8> image = WorldFile::serialize(w);
+    std::string path = std::string("amphitude-") + reason + "-" + std::to_string(simTick) + ".world";
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (out.write(reinterpret_cast<const char*>(image.data()), image.size())) {
+        std::cout << "World saved to " << path << std::endl;
+    }
+}
+
+void Game::captureDigest(WorldDigest& d, Uint32 tick) const {
+    memset(&d, 0, sizeof(d)); // Padding too, the digest goes on the wire
+    d.tick = tick;
+    d.gameTicks = gameTicks;
+    d.skippedPlayer = isOnline ? 1 : 0xFF;
+    d.numPlayers = static_cast<Uint8>(players.size());
+
+    StateHasher world;
+    world.add(tick);
+    world.add(gameTicks);
+
+    for (int i = 0; i < d.numPlayers; ++i) {
+        const Player& pl = players[i];
+        PlayerDigest& pd = d.players[i];
+        pd.x = pl.x; pd.y = pl.y;
+        pd.vx = pl.vx; pd.vy = pl.vy;
+        pd.hp = pl.hp;
+        pd.powerTimer = static_cast<Sint16>(pl.powerTimer);
+        pd.invincible = static_cast<Sint16>(pl.invincible);
+        pd.attackCooldown = static_cast<Sint16>(pl.attackCooldown);
+        pd.facing = static_cast<Sint8>(pl.facing);
+        pd.onGround = pl.onGround ? 1 : 0;
+        pd.power = pl.power;
+
+        if (d.skippedPlayer == i) continue;
+        world.addFloat(pd.x); world.addFloat(pd.y);
+        world.addFloat(pd.vx); world.addFloat(pd.vy);
+        world.add(static_cast<Sint16>(pd.hp)); // As a snapshot carries it
+        world.add(pd.powerTimer); world.add(pd.invincible); world.add(pd.attackCooldown);
+        world.add(pd.facing); world.add(pd.onGround); world.add(pd.power);
+    }
+
+    // Entity order differs between host and client, so per-entity hashes are summed.
+    // Only the entities a snapshot has room for: the client never sees the rest.
+    size_t projectileCount = std::min<size_t>(projectiles.size(), SNAPSHOT_PROJECTILES);
+    size_t powerUpCount = std::min<size_t>(powerUps.size(), SNAPSHOT_POWER_UPS);
+    for (size_t i = 0; i < projectileCount; ++i) {
+        StateHasher e;
+        e.add(projectiles.netId[i]);
+        e.addFloat(projectiles.x[i]); e.addFloat(projectiles.y[i]);
+        e.addFloat(projectiles.vx[i]); e.addFloat(projectiles.vy[i]);
+        e.add(projectiles.owner[i]);
+        e.add(projectiles.type[i]);
+        d.projectileHash += e.value();
+    }
+    for (size_t i = 0; i < powerUpCount; ++i) {
+        StateHasher e;
+        e.add(powerUps.netId[i]);
+        e.addFloat(powerUps.x[i]); e.addFloat(powerUps.y[i]);
+        e.add(powerUps.life[i]);
+        e.add(powerUps.type[i]);
+        d.powerUpHash += e.value();
+    }
+    d.numProjectiles = static_cast<Uint8>(projectileCount);
+    d.numPowerUps = static_cast<Uint8>(powerUpCount);
+    world.add(d.numProjectiles); world.add(d.projectileHash);
+    world.add(d.numPowerUps); world.add(d.powerUpHash);
+
+    // Both peers must be at the same point of the gameplay stream
+    world.add(powerUpSpawns);
+    for (Uint32 word : gameplayRng.s) world.add(word);
+
+    d.hash = world.value();
 }
 
 void Game::handleEvents(SDL_Event& event) {
@@ -271,14 +949,18 @@ void Game::handleEvents(SDL_Event& event) {
                         SDL_StartTextInput();
                         ignoreInputFrames = 2; // Prevent 'j' from being typed
                     }
-                    if (event.key.keysym.sym == SDLK_l) {
-                        // Local Game
+                    if (event.key.keysym.sym == SDLK_l || event.key.keysym.sym == SDLK_c) {
+                        // Local Game (C: against the computer)
                         isOnline = false;
+                        vsCpu = event.key.keysym.sym == SDLK_c;
                         resetGame();
                         currentState = CHARACTER_SELECT;
                         // Skip lobby for local? Or go to lobby? Let's go to lobby for char select.
                         typingName = false;
                     }
+                    if (event.key.keysym.sym == SDLK_d) {
+                        botDifficulty = static_cast<Bot::Difficulty>((botDifficulty + 1) % Bot::DIFFICULTY_COUNT);
+                    }
                     if (event.key.keysym.sym == SDLK_s) {
                          // Toggle Season
                          if (currentSeason == SEASON_GREEN) currentSeason = SEASON_SNOW;
@@ -381,23 +1063,14 @@ void Game::handleEvents(SDL_Event& event) {
             else if (currentState == PLAYING) {
                 if (event.key.keysym.sym == SDLK_ESCAPE) {
                     currentState = PAUSED;
-                    pauseTime = 10.0f; // 10 seconds auto-forfeit
+                    pauseTicks = GameConstants::PAUSE_FORFEIT_TICKS; // 10 seconds auto-forfeit
                 }
                 // if (event.key.keysym.sym == SDLK_SPACE) currentState = MENU; // Removed to prevent accidental quit
 
-                // Player 1 (WASD)
-                if (event.key.keysym.sym == SDLK_a) players[0].keyLeft = true;
-                if (event.key.keysym.sym == SDLK_d) players[0].keyRight = true;
-                if (event.key.keysym.sym == SDLK_w) players[0].keyJump = true;
-                if (event.key.keysym.sym == SDLK_s) players[0].keyDown = true;
-                if (event.key.keysym.sym == SDLK_f) players[0].keyAttack = true;
-
-                // Player 2 (Arrows)
-                if (event.key.keysym.sym == SDLK_LEFT) players[1].keyLeft = true;
-                if (event.key.keysym.sym == SDLK_RIGHT) players[1].keyRight = true;
-                if (event.key.keysym.sym == SDLK_UP) players[1].keyJump = true;
-                if (event.key.keysym.sym == SDLK_DOWN) players[1].keyDown = true;
-                if (event.key.keysym.sym == SDLK_RETURN) players[1].keyAttack = true;
+                // Each player's keys (P1 WASD, P2 Arrows, P3 IJKL, P4 Numpad); online only our own
+                for (size_t i = 0; i < players.size() && i < NUM_KEY_LAYOUTS; ++i) {
+                    if (isLocalPlayer(i)) applyKey(players[i], KEY_LAYOUTS[i], event.key.keysym.sym, true);
+                }
             }
             else if (currentState == EXIT_CONFIRM) {
                 if (event.key.keysym.sym == SDLK_y) {
@@ -496,17 +1169,9 @@ void Game::handleEvents(SDL_Event& event) {
         }
         // Key Release Handling
         if (event.type == SDL_KEYUP && currentState == PLAYING) {
-            if (event.key.keysym.sym == SDLK_a) players[0].keyLeft = false;
-            if (event.key.keysym.sym == SDLK_d) players[0].keyRight = false;
-            if (event.key.keysym.sym == SDLK_w) players[0].keyJump = false;
-            if (event.key.keysym.sym == SDLK_s) players[0].keyDown = false;
-            if (event.key.keysym.sym == SDLK_f) players[0].keyAttack = false;
-
-            if (event.key.keysym.sym == SDLK_LEFT) players[1].keyLeft = false;
-            if (event.key.keysym.sym == SDLK_RIGHT) players[1].keyRight = false;
-            if (event.key.keysym.sym == SDLK_UP) players[1].keyJump = false;
-            if (event.key.keysym.sym == SDLK_DOWN) players[1].keyDown = false;
-            if (event.key.keysym.sym == SDLK_RETURN) players[1].keyAttack = false;
+            for (size_t i = 0; i < players.size() && i < NUM_KEY_LAYOUTS; ++i) {
+                if (isLocalPlayer(i)) applyKey(players[i], KEY_LAYOUTS[i], event.key.keysym.sym, false);
+            }
         }
     }
 }
@@ -540,10 +1205,8 @@ void Game::update() {
              // Set names to default so we don't start blank
              p1NameInput = "Host";
              p2NameInput = "Client";
-         } else if (net.hasPeer) {
-             // We have a peer target, so spam PUNCH packets every frame (or every few frames)
-             net.sendPunch();
          }
+         // Hole punch probes are paced by NetworkManager::update()
     }
 
     // ... (Inside CHARACTER_SELECT) ...
@@ -551,10 +1214,6 @@ void Game::update() {
 
     if (currentState == CHARACTER_SELECT) {
         if (isOnline) {
-             if (net.hasPeer && !net.connected) {
-                 net.sendPunch(); // Keep punching until fully connected logic takes over in NetworkManager
-             }
-
             if (!net.connected && !net.hasPeer) { // If connected flag drops and we aren't trying to connect
                 // Peer disconnected
                 isOnline = false;
@@ -568,20 +1227,23 @@ void Game::update() {
             else if (net.isHost) {
                 // Host Logic (Same as before but over UDP)
                 // ...
-                Packet p;
+                Packet p = {};
                 p.type = 2; // State 
                 p.gameState = CHARACTER_SELECT;
                 p.p1Char = p1Character;
                 strncpy(p.p1Name, p1NameInput.c_str(), 19); p.p1Name[19] = '\0';
                 p.p1Ready = p1Ready;
-                // Sync Timer to Client
-                p.startTimer = countingDown ? lobbyStartTimer : -1.0f;
-                net.send(p); // UDP Send
+                p.levelChecksum = level.checksum();
+                // Sync Timer to Client (quarter-second steps, so the countdown isn't a change every frame)
+                const int quarter = GameConstants::TICK_RATE / 4;
+                p.startTicks = countingDown ? (lobbyStartTicks + quarter - 1) / quarter * quarter : -1;
+                if (net.shouldSend(NetworkManager::CHANNEL_LOBBY, p)) net.send(p); // UDP Send
 
                 Packet p2P;
                 // UDP receive returns true if packet matches our protocol
                 for (; net.receive(p2P); ) {
                     if (p2P.type == 2) {
+                        if (!samePeerLevel(p2P)) return;
                         p2Character = p2P.p2Char;
                         p2NameInput = p2P.p2Name;
                         p2Ready = p2P.p2Ready;
@@ -593,23 +1255,26 @@ void Game::update() {
                 if (p1Ready && p2Ready) {
                      if (!countingDown) {
                          countingDown = true;
-                         lobbyStartTimer = 3.9f; // Start closer to 4 so it shows 3 immediately
+                         lobbyStartTicks = GameConstants::LOBBY_COUNTDOWN_TICKS;
                      }
                 } else {
                      countingDown = false;
-                     lobbyStartTimer = 0.0f;
+                     lobbyStartTicks = 0;
                 }
                 
                 if (countingDown) {
-                     lobbyStartTimer -= 1.0f / 60.0f; // Approx 60 FPS
-                     if (lobbyStartTimer <= 0) {
+                     lobbyStartTicks--;
+                     if (lobbyStartTicks <= 0) {
                          // TIME'S UP -> START GAME!
                          std::cout << "Both Ready! Starting Game..." << std::endl;
                          
                          // 1. Send Start Packet to Client (Reliable)
-                         Packet startP;
+                         Packet startP = {};
                          startP.type = 3; // Start Game
-                         startP.gameTime = GameConstants::GAME_DURATION;
+                         startP.gameTicks = GameConstants::GAME_DURATION_TICKS;
+                         matchSeed = Random::entropySeed();
+                         startP.matchSeed = matchSeed;
+                         startP.levelChecksum = level.checksum();
                          strncpy(startP.p1Name, p1NameInput.c_str(), 19);
                          
                          net.sendReliable(startP);
@@ -628,17 +1293,21 @@ void Game::update() {
             } else {
                 // Client Logic (UDP)
                 // ...
-                Packet p;
+                Packet p = {};
                 p.type = 2;
                 p.p2Char = p2Character;
                 strncpy(p.p2Name, p2NameInput.c_str(), 19); p.p2Name[19] = '\0';
                 p.p2Ready = p2Ready;
-                net.send(p);
+                p.levelChecksum = level.checksum();
+                if (net.shouldSend(NetworkManager::CHANNEL_LOBBY, p)) net.send(p);
 
                 Packet hostP;
                 for (; net.receive(hostP); ) {
+                    if ((hostP.type == 2 || hostP.type == 3) && !samePeerLevel(hostP)) return;
                     if (hostP.type == 2) {
                         if (hostP.gameState == PLAYING) {
+                             // Start packet lost: the snapshots carry the seed too
+                             matchSeed = hostP.matchSeed;
                              players[0].name = p1NameInput; // Use last known name
                              players[1].name = p2NameInput;
                              resetGame();
@@ -649,10 +1318,11 @@ void Game::update() {
                         p1NameInput = hostP.p1Name;
                         p1Ready = hostP.p1Ready;
                         // Client Receives Timer
-                        lobbyStartTimer = hostP.startTimer;
+                        lobbyStartTicks = hostP.startTicks;
                     } else if (hostP.type == 3) {
                          // Received RELIABLE Start Packet
                          // net.receive() sends ACK automatically for Type 3
+                         matchSeed = hostP.matchSeed;
                          players[0].name = p1NameInput;
                          players[1].name = p2NameInput;
                          resetGame();
@@ -692,16 +1362,15 @@ void Game::update() {
             if (net.isHost) {
                 // HOST: Receive P2 Input, Update Physics, Send State
                 Packet p2Input;
-                // Drain the socket to get the LATEST input packet
-                // This prevents input lag if packets pile up in the buffer
+                // Drain the socket and queue every input by tick.
+                // Inputs are applied one per frame below, so taps aren't lost.
                 for (; net.receive(p2Input); ) {
                     if (p2Input.type == 1) {
-                        // Apply P2 Input
-                        players[1].keyLeft = p2Input.keys[0]; // Left
-                        players[1].keyRight = p2Input.keys[1]; // Right
-                        players[1].keyJump = p2Input.keys[2]; // Jump
-                        players[1].keyDown = p2Input.keys[3]; // Down
-                        players[1].keyAttack = p2Input.keys[4]; // Attack
+                        queueRemoteInput(p2Input);
+                        if (!desync.check(p2Input.checksums, "client") && !worldDumped) {
+                            dumpWorld("desync");
+                            worldDumped = true;
+                        }
                     }
                 }
                 
@@ -722,79 +1391,37 @@ void Game::update() {
                 // Update Game Logic (Host Authority)
                 // Physics happens at the end of Game::update via player.update()
                 
-                Packet stateP;
-                stateP.type = 2; // Game State
-                stateP.gameTime = gameTime;
-                
-                stateP.p1X = players[0].x;
-                stateP.p1Y = players[0].y;
-                stateP.p1VX = players[0].vx;
-                stateP.p1VY = players[0].vy;
-                stateP.p1HP = players[0].hp;
-                strncpy(stateP.p1Power, players[0].power.c_str(), 19); stateP.p1Power[19] = '\0';
-                stateP.p1PowerTimer = players[0].powerTimer;
-                stateP.p1Invincible = players[0].invincible;
-                stateP.p1AttackCooldown = players[0].attackCooldown;
-                stateP.p1FacingLeft = (players[0].facing == -1);
-
-                stateP.p2X = players[1].x;
-                stateP.p2Y = players[1].y;
-                stateP.p2VX = players[1].vx;
-                stateP.p2VY = players[1].vy;
-                stateP.p2HP = players[1].hp;
-                strncpy(stateP.p2Power, players[1].power.c_str(), 19); stateP.p2Power[19] = '\0';
-                stateP.p2PowerTimer = players[1].powerTimer;
-                stateP.p2Invincible = players[1].invincible;
-                stateP.p2AttackCooldown = players[1].attackCooldown;
-                stateP.p2FacingLeft = (players[1].facing == -1);
-
-                // Sync PowerUps
-                stateP.numPowerUps = 0;
-                for (const auto& pu : powerUps) {
-                    if (stateP.numPowerUps < 5) {
-                        stateP.powerUps[stateP.numPowerUps].x = pu.x;
-                        stateP.powerUps[stateP.numPowerUps].y = pu.y;
-                        strncpy(stateP.powerUps[stateP.numPowerUps].type, pu.type.c_str(), 19);
-                        stateP.powerUps[stateP.numPowerUps].type[19] = '\0';
-                        stateP.numPowerUps++;
-                    }
-                }
+                Packet stateP = {};
+                writeSnapshot(stateP);
 
-                // Sync Projectiles
-                stateP.numProjectiles = 0;
-                for (const auto& proj : projectiles) {
-                    if (stateP.numProjectiles < 10) {
-                        stateP.projectiles[stateP.numProjectiles].x = proj.x;
-                        stateP.projectiles[stateP.numProjectiles].y = proj.y;
-                        stateP.projectiles[stateP.numProjectiles].vx = proj.vx;
-                        stateP.projectiles[stateP.numProjectiles].vy = proj.vy;
-                        stateP.projectiles[stateP.numProjectiles].owner = proj.owner;
-                        strncpy(stateP.projectiles[stateP.numProjectiles].type, proj.type.c_str(), 9);
-                        stateP.projectiles[stateP.numProjectiles].type[9] = '\0';
-                        stateP.numProjectiles++;
-                    }
+                // Fixed snapshot rate, independent of our frame rate
+                if (net.shouldSend(NetworkManager::CHANNEL_SNAPSHOT, stateP)) {
+                    finishSnapshot(stateP);
+                    net.send(stateP);
                 }
 
-                // Sync Game State (Game Over)
-                stateP.gameState = currentState;
-                if (currentState == GAMEOVER) {
-                    if (players[0].hp <= 0) stateP.winnerId = 2;
-                    else if (players[1].hp <= 0) stateP.winnerId = 1;
-                    else stateP.winnerId = 0; // Time out?
-                }
-
-                net.send(stateP);
+                // Client input for this frame's simulation
+                applyNextRemoteInput();
                 
             } else {
                 // CLIENT: Send P2 Input, Receive State
-                Packet p2Input;
-                p2Input.type = 1; // Input
-                p2Input.keys[0] = players[1].keyLeft;
-                p2Input.keys[1] = players[1].keyRight;
-                p2Input.keys[2] = players[1].keyJump;
-                p2Input.keys[3] = players[1].keyDown;
-                p2Input.keys[4] = players[1].keyAttack;
-                net.send(p2Input);
+                // Sample this frame's input under a new tick and remember it for replays
+                localInputTick++;
+                PredictedFrame& frame = inputHistory[localInputTick % INPUT_HISTORY_SIZE];
+                frame.tick = localInputTick;
+                frame.input = players[1].getInputBits();
+
+                if (net.isSendDue(NetworkManager::CHANNEL_INPUT)) {
+                    Packet p2Input = {};
+                    p2Input.type = 1; // Input
+                    p2Input.inputTick = localInputTick;
+                    for (int k = 0; k < 8; ++k) {
+                        const PredictedFrame& older = inputHistory[(localInputTick - k) % INPUT_HISTORY_SIZE];
+                        p2Input.inputHistory[k] = (older.tick == localInputTick - k) ? older.input : 0;
+                    }
+                    if (desync.reportDue()) desync.fillReport(p2Input.checksums);
+                    net.send(p2Input);
+                }
 
                 Packet hostState;
                 // Drain socket to get LATEST state
@@ -808,65 +1435,13 @@ void Game::update() {
                             return; // Exit update to prevent applying game state
                         }
 
-                        // Apply Host State
-                        players[0].x = hostState.p1X;
-                        players[0].y = hostState.p1Y;
-                        players[0].vx = hostState.p1VX;
-                        players[0].vy = hostState.p1VY;
-                        players[0].hp = hostState.p1HP;
-                        players[0].power = hostState.p1Power;
-                        players[0].powerTimer = hostState.p1PowerTimer;
-                        players[0].invincible = hostState.p1Invincible;
-                        players[0].attackCooldown = hostState.p1AttackCooldown;
-                        players[0].facing = hostState.p1FacingLeft ? -1 : 1;
-
-                        players[1].x = hostState.p2X;
-                        players[1].y = hostState.p2Y;
-                        players[1].vx = hostState.p2VX;
-                        players[1].vy = hostState.p2VY;
-                        players[1].hp = hostState.p2HP;
-                        players[1].power = hostState.p2Power;
-                        players[1].powerTimer = hostState.p2PowerTimer;
-                        players[1].invincible = hostState.p2Invincible;
-                        players[1].attackCooldown = hostState.p2AttackCooldown;
-                        players[1].facing = hostState.p2FacingLeft ? -1 : 1;
-
-                        // Sync Game Time
-                        gameTime = hostState.gameTime;
-
-                        // Sync PowerUps
-                        powerUps.clear();
-                        for (int i = 0; i < hostState.numPowerUps; i++) {
-                            PowerUp pu;
-                            pu.x = hostState.powerUps[i].x;
-                            pu.y = hostState.powerUps[i].y;
-                            pu.width = 30; // Default size
-                            pu.height = 30;
-                            pu.type = hostState.powerUps[i].type;
-                            pu.bobTimer = 0; // Visuals can be local
-                            pu.lifetime = 600; // Assume fresh or keep host's if we synced it
-                            powerUps.push_back(pu);
-                        }
+                        if (!samePeerLevel(hostState)) return;
+                        if (static_cast<size_t>(hostState.numPlayers) != players.size()) continue; // Not this match
 
-                        // Sync Projectiles
-                        projectiles.clear();
-                        for (int i = 0; i < hostState.numProjectiles; i++) {
-                            Projectile proj;
-                            proj.x = hostState.projectiles[i].x;
-                            proj.y = hostState.projectiles[i].y;
-                            proj.vx = hostState.projectiles[i].vx;
-                            proj.vy = hostState.projectiles[i].vy;
-                            proj.owner = hostState.projectiles[i].owner;
-                            proj.type = hostState.projectiles[i].type;
-                            proj.width = 15; // Default size
-                            proj.height = 15;
-                            projectiles.push_back(proj);
-                        }
-
-                        // Sync Game State
-                        if (hostState.gameState == GAMEOVER) {
-                            currentState = GAMEOVER;
-                            winnerId = hostState.winnerId;
+                        // Apply it; the rebuilt world is checked against the host's digest of the same tick
+                        if (!applySnapshot(hostState) && !worldDumped) {
+                            dumpWorld("desync");
+                            worldDumped = true;
                         }
                     }
                 }
@@ -891,25 +1466,22 @@ void Game::update() {
         if (isOnline) {
             if (net.isHost) {
                 // HOST: Continue sending Game Over state so Client knows
-                Packet stateP;
+                Packet stateP = {};
                 stateP.type = 2; // Game State
-                stateP.gameTime = gameTime;
+                stateP.gameTicks = gameTicks;
                 stateP.gameState = GAMEOVER;
                 
                 // Ensure winner is consistent
-                if (players[0].hp <= 0) winnerId = 2;
-                else if (players[1].hp <= 0) winnerId = 1;
-                // If forfeit, winnerId should have been set in handleEvents. 
-                // If not set (0), check HP. If still 0, maybe draw?
-                // But handleEvents sets HP to 0 for quitter.
+                // A forfeit sets the quitter's HP to 0 in handleEvents, so it is covered here too
+                if (alivePlayers() <= 1) winnerId = decideWinner();
                 
                 stateP.winnerId = winnerId;
 
                 // Sync HP too just in case
-                stateP.p1HP = players[0].hp;
-                stateP.p2HP = players[1].hp;
+                stateP.numPlayers = static_cast<Uint8>(players.size());
+                for (size_t i = 0; i < players.size(); ++i) writeNetPlayer(stateP.players[i], players[i]);
                 
-                net.send(stateP);
+                if (net.shouldSend(NetworkManager::CHANNEL_GAMEOVER, stateP)) net.send(stateP);
                 
                 if (!net.connected) {
                      isOnline = false;
@@ -934,8 +1506,9 @@ void Game::update() {
                             p2Ready = false;
                         }
                         // Update HP/Winner if we missed it?
-                        players[0].hp = p.p1HP;
-                        players[1].hp = p.p2HP;
+                        for (size_t i = 0; i < players.size() && i < static_cast<size_t>(p.numPlayers); ++i) {
+                            players[i].hp = p.players[i].hp;
+                        }
                         if (p.gameState == GAMEOVER) {
                              winnerId = p.winnerId;
                         }
@@ -958,218 +1531,356 @@ void Game::update() {
             }
         } else {
              // Local Game Over Logic
-             if (players[0].hp <= 0) winnerId = 2;
-             else if (players[1].hp <= 0) winnerId = 1;
+             if (alivePlayers() <= 1) winnerId = decideWinner();
         }
     }
     
 
 
     if (currentState == PAUSED) {
-        pauseTime -= 1.0f / 60.0f;
-        if (pauseTime <= 0) {
+        pauseTicks--;
+        if (pauseTicks <= 0) {
             currentState = GAMEOVER;
         }
         return;
     }
     if (currentState != PLAYING) return;
 
-    // Update Players
+    // CPU players pick their keys for this tick
+    for (auto& bot : bots) bot->update(*this);
+    simulateTick();
+    followCamera(false);
+}
+
+void Game::simulateTick() {
+    // Update Players (the knocked out sit the rest of the match out)
+    for (auto& player : players) {
+        if (player.hp > 0) player.update(level, projectiles, frameEvents);
+    }
+    assignNetIds();
+
+    // Pack players where they ended up; pickups, PvP and projectile hits scan these columns
+    for (size_t i = 0; i < PLAYER_LANES; ++i) packPlayerBox(i);
+
+    // Box around every player still in: power-ups outside it sleep through the pickup test
+    float awakeLeft = AabbBatch::FAR, awakeTop = AabbBatch::FAR, awakeRight = -AabbBatch::FAR, awakeBottom = -AabbBatch::FAR;
+    for (const Player& p : players) {
+        if (p.hp <= 0) continue;
+        awakeLeft = std::min(awakeLeft, p.x); awakeRight = std::max(awakeRight, p.x + p.width);
+        awakeTop = std::min(awakeTop, p.y); awakeBottom = std::max(awakeBottom, p.y + p.height);
+    }
+
+    // Client-Side Prediction: Remember what this tick's input predicted
+    if (isOnline && !net.isHost) {
+        PredictedFrame& frame = inputHistory[localInputTick % INPUT_HISTORY_SIZE];
+        const Player& me = players[1];
+        frame.x = me.x; frame.y = me.y;
+        frame.vx = me.vx; frame.vy = me.vy;
+        frame.onGround = me.onGround;
+    }
+
+    // Glide any prediction correction out over a few frames
     for (auto& player : players) {
-        player.update(platforms, projectiles, particles);
+        player.renderOffsetX *= 0.8f;
+        player.renderOffsetY *= 0.8f;
+        if (std::abs(player.renderOffsetX) < 0.1f) player.renderOffsetX = 0;
+        if (std::abs(player.renderOffsetY) < 0.1f) player.renderOffsetY = 0;
     }
 
     // Spawn Power-ups periodically
-    Uint32 currentTime = SDL_GetTicks();
-    if (currentTime - lastPowerUpTime > GameConstants::POWER_UP_SPAWN_INTERVAL) {
+    if (--powerUpSpawnTicks <= 0) {
         spawnPowerUps();
-        lastPowerUpTime = currentTime;
+        powerUpSpawnTicks = GameConstants::POWER_UP_SPAWN_TICKS;
     }
 
     // Power-up collection
-    for (auto it = powerUps.begin(); it != powerUps.end(); ) {
-        // Bobbing animation
-        it->bobTimer++;
-        it->y += sin(it->bobTimer * 0.1f) * 0.5f;
-        
-        // Lifetime Check
-        it->lifetime--;
-        if (it->lifetime <= 0) {
-            it = powerUps.erase(it);
+    // Age (the bobbing is drawn from the timer), one pass over the columns
+    for (size_t i = 0; i < powerUps.size(); ++i) {
+        powerUps.timer[i]++;
+        powerUps.life[i]--;
+    }
+
+    // Expiry and pickup (swap-and-pop removal: stay on index i after removing).
+    // The client leaves both to the host's snapshots.
+    for (size_t i = 0; i < powerUps.size() && (!isOnline || net.isHost); ) {
+        if (powerUps.life[i] <= 0) {
+            powerUps.remove(i);
             continue;
         }
 
-        bool collected = false;
-        for (auto& player : players) {
-            if (checkCollision(player.x, player.y, player.width, player.height,
-                             it->x, it->y, it->width, it->height)) {
-                // Apply Effect
-                player.power = it->type;
-                player.powerTimer = GameConstants::POWER_DURATION;
-                
-                if (it->type == "health") player.hp = std::min(player.maxHp, player.hp + GameConstants::HEALTH_PICKUP);
-                
-                // Visuals
-                createParticles(particles, it->x, it->y, {255, 215, 0, 255}, GameConstants::COLLECT_PARTICLE_COUNT);
-                collected = true;
-                break;
-            }
+        if (!checkCollision(powerUps.x[i], powerUps.y[i], powerUps.w[i], powerUps.h[i],
+                            awakeLeft, awakeTop, awakeRight - awakeLeft, awakeBottom - awakeTop)) {
+            ++i;
+            continue;
         }
-        if (collected) it = powerUps.erase(it);
-        else ++it;
-    }
-
-    // PvP Collision (Player vs Player)
-    if (checkCollision(players[0].x, players[0].y, players[0].width, players[0].height,
-                     players[1].x, players[1].y, players[1].width, players[1].height)) {
-        if (players[0].invincible == 0 && players[1].invincible == 0) {
-            // Bounce back
-            float knockback = GameConstants::KNOCKBACK_FORCE;
-            if (players[0].x < players[1].x) {
-                players[0].vx = -knockback; players[1].vx = knockback;
-            } else {
-                players[0].vx = knockback; players[1].vx = -knockback;
-            }
-            // Deal damage
-            float p1Damage = GameConstants::COLLISION_DAMAGE;
-            float p2Damage = GameConstants::COLLISION_DAMAGE;
 
-            // Rhino Logic (Shield = Rhino)
-            bool p1Rhino = (players[0].power == "shield");
-            bool p2Rhino = (players[1].power == "shield");
-            
-            // Check for Attacking (Any active attack: Fire, Dash, Lunge)
-            // Rhino is attacking if cooldown is active OR moving faster than normal max speed (Charging)
-            bool p1Attacking = players[0].attackCooldown > 0 || (p1Rhino && std::abs(players[0].vx) > GameConstants::MAX_VELOCITY_X);
-            bool p2Attacking = players[1].attackCooldown > 0 || (p2Rhino && std::abs(players[1].vx) > GameConstants::MAX_VELOCITY_X);
-
-            if (p1Rhino && p2Rhino) {
-                if (p1Attacking && p2Attacking) {
-                    // CLASH! Both lose power
-                    players[0].power = ""; players[0].texture = players[0].normalTexture;
-                    players[1].power = ""; players[1].texture = players[1].normalTexture;
-                    p1Damage = 0; p2Damage = 0;
-                    // Visual effect
-                    createParticles(particles, players[0].x + players[0].width, players[0].y + players[0].height/2, {255, 255, 255, 255}, 20);
-                } else {
-                    // Just bumping into each other
-                    p1Damage = 0; p2Damage = 0;
-                }
-            }
-            else if (p1Rhino) {
-                if (p2Attacking && !p1Attacking) {
-                    // Counter! P2 attacks Passive Rhino -> Rhino loses power
-                    players[0].power = ""; players[0].texture = players[0].normalTexture;
-                    p1Damage = 0; // Rhino takes no HP damage from the hit that breaks shield
-                }
-                
-                if (p1Attacking) {
-                    // Rhino Charge! P2 takes double damage
-                    p2Damage *= GameConstants::RHINO_DAMAGE_MULTIPLIER;
-                    p1Damage = 0; // Rhino takes no damage while charging
-                } else if (!p2Attacking) {
-                     // Passive Rhino bump
-                     p1Damage = 0;
-                }
-            }
-            else if (p2Rhino) {
-                if (p1Attacking && !p2Attacking) {
-                    // Counter! P1 attacks Passive Rhino -> Rhino loses power
-                    players[1].power = ""; players[1].texture = players[1].normalTexture;
-                    p2Damage = 0;
-                }
-                
-                if (p2Attacking) {
-                    // Rhino Charge! P1 takes double damage
-                    p1Damage *= GameConstants::RHINO_DAMAGE_MULTIPLIER;
-                    p2Damage = 0;
-                } else if (!p1Attacking) {
-                    // Passive Rhino bump
-                    p2Damage = 0;
-                }
-            }
-            else {
-                // Normal vs Normal
-                if (p1Attacking && !p2Attacking) {
-                    // P1 Hits P2
-                    p1Damage = 0;
-                    p2Damage = GameConstants::COLLISION_DAMAGE;
-                } else if (!p1Attacking && p2Attacking) {
-                    // P2 Hits P1
-                    p1Damage = GameConstants::COLLISION_DAMAGE;
-                    p2Damage = 0;
-                } else {
-                    // Both Attacking (Clash) or Both Passive (Bump) -> Both take damage
-                    p1Damage = GameConstants::COLLISION_DAMAGE;
-                    p2Damage = GameConstants::COLLISION_DAMAGE;
-                }
-            }
-
-            players[0].takeDamage(p1Damage, particles);
-            players[1].takeDamage(p2Damage, particles);
+        // The first player (lowest index) touching it collects it
+        uint64_t mask[AabbBatch::maskWords(PLAYER_LANES)];
+        AabbBatch::overlaps(powerUps.x[i], powerUps.y[i], powerUps.w[i], powerUps.h[i], playerBoxes(), mask);
+        size_t pi = AabbBatch::firstHit(mask, PLAYER_LANES);
+        if (pi == PLAYER_LANES) {
+            ++i;
+            continue;
         }
-    }
 
-    // Projectiles Logic
-    for (auto it = projectiles.begin(); it != projectiles.end(); ) {
-        it->x += it->vx; it->y += it->vy;
-        
+        // Apply Effect
+        Player& player = players[pi];
+        player.power = static_cast<PowerType>(powerUps.type[i]);
+        player.powerTimer = GameConstants::POWER_DURATION;
+
+        float heal = ability(player.power).healOnPickup;
+        if (heal > 0) player.hp = std::min(player.maxHp, player.hp + heal);
+
+        // Visuals
+        GameEvent e = {};
+        e.type = GameEvent::PICKUP;
+        e.arg = static_cast<Uint8>(player.id - 1);
+        e.x = static_cast<Sint16>(powerUps.x[i]);
+        e.y = static_cast<Sint16>(powerUps.y[i]);
+        frameEvents.push_back(e);
+        powerUps.remove(i);
+    }
 
+    // PvP Collision (Player vs Player): each overlapping pair once, found by a batch scan.
+    // A resolved pair is re-packed, so later scans see the bounce (and knockouts).
+    for (size_t i = 0; i < players.size(); ++i) {
+        Player& a = players[i];
+        if (a.hp <= 0) continue;
+        uint64_t mask[AabbBatch::maskWords(PLAYER_LANES)];
+        AabbBatch::overlaps(a.x, a.y, a.width, a.height, playerBoxes(), mask);
+        AabbBatch::forEachHit(mask, PLAYER_LANES, [&](size_t j) {
+            if (j <= i || players[j].hp <= 0) return;
+            resolvePlayerCollision(a, players[j]);
+            packPlayerBox(i);
+            packPlayerBox(j);
+        });
+    }
 
-        bool hit = false;
-        for (auto& player : players) {
-            // Don't hit self
-            if ((player.id - 1) != it->owner &&
-                checkCollision(it->x - it->width/2, it->y - it->height/2, it->width, it->height,
-                             player.x, player.y, player.width, player.height) &&
-                player.invincible == 0) {
-                
-                player.takeDamage(GameConstants::PROJECTILE_DAMAGE, particles);
-                player.vx = it->vx * 0.5f; player.vy = -5; // Knockback
-                hit = true;
-                break;
-            }
+    // Projectiles Logic: each move is swept, so a projectile stops at the first
+    // player or platform along its path instead of skipping over it between ticks.
+    // The sweeps only read the world and run in parallel; hits are applied after, in order.
+    int projectileCount = static_cast<int>(projectiles.size());
+    projectileHits.resize(projectileCount);
+    jobs.parallelFor(0, projectileCount, PROJECTILES_PER_JOB, [this](int begin, int end) {
+        thread_local std::vector<Uint16> scratch;
+        for (int i = begin; i < end; ++i) sweepProjectile(i, scratch, projectileHits[i]);
+    });
+    for (int i = 0; i < projectileCount; ++i) {
+        ProjectileHit& hit = projectileHits[i];
+        // An earlier projectile may have just made the target invincible: sweep again, as in order
+        if (hit.target >= 0 && players[hit.target].invincible != 0) sweepProjectile(i, sweepScratch, hit);
+
+        float dx = projectiles.vx[i], dy = projectiles.vy[i];
+        projectiles.x[i] += dx * hit.time;
+        projectiles.y[i] += dy * hit.time;
+        if (hit.target >= 0) {
+            Player& target = players[hit.target];
+            target.takeDamage(GameConstants::PROJECTILE_DAMAGE, frameEvents, DAMAGE_PROJECTILE);
+            target.vx = dx * 0.5f; target.vy = -5; // Knockback
         }
-        // Remove if hit or out of bounds
-        if (hit || it->x < 0 || it->x > GameConstants::WINDOW_WIDTH) it = projectiles.erase(it);
-        else ++it;
     }
 
+    // Remove if hit or out of bounds (back to front: swap-and-pop only moves entries already kept)
+    for (int i = projectileCount - 1; i >= 0; --i) {
+        const ProjectileHit& hit = projectileHits[i];
+        float px = projectiles.x[i];
+        if (hit.target >= 0 || hit.wall >= 0 || px < 0 || px > level.width()) projectiles.remove(i);
+    }
+
+    // Turn this frame's events into effects (and queue them for the client)
+    processEvents();
+    simTick++;
+
     // Update Particles
-    for (auto& p : particles) p.update();
-    particles.erase(std::remove_if(particles.begin(), particles.end(),
-        [](const Particle& p) { return !p.active; }), particles.end());
+    particles.update(&jobs);
 
-    // Win/Loss Condition (HP <= 0)
-    if (players[0].hp <= 0) {
-        winnerId = 2;
-        currentState = GAMEOVER;
-    } else if (players[1].hp <= 0) {
-        winnerId = 1;
+    // Win/Loss Condition: last one standing
+    if (alivePlayers() <= 1) {
+        winnerId = decideWinner();
         currentState = GAMEOVER;
     }
 
     // Timer Logic
-    if (gameTime > 0) {
-        gameTime -= 1.0f / 60.0f; // Assuming 60 FPS
-        if (gameTime <= 0) {
-            gameTime = 0;
+    if (gameTicks > 0) {
+        gameTicks--;
+        if (gameTicks <= 0) {
+            gameTicks = 0;
             currentState = GAMEOVER;
             
-            // Time Out: Player with Higher HP Wins
-            if (players[0].hp > players[1].hp) winnerId = 1;
-            else if (players[1].hp > players[0].hp) winnerId = 2;
-            else winnerId = 0; // Draw
+            // Time Out: Player with Higher HP Wins (tie = Draw)
+            winnerId = decideWinner();
         }
     }
 
-    // Check Win Condition (Death)
-    if (players[0].hp <= 0 || players[1].hp <= 0) {
-        currentState = GAMEOVER;
+    // Host: digest the finished tick (the client digests the snapshots it applies)
+    if (isOnline && net.isHost) {
+        WorldDigest digest;
+        captureDigest(digest, simTick);
+        desync.record(digest);
+    }
+}
+
+void Game::packPlayerBox(size_t i) {
+    if (i < players.size() && players[i].hp > 0) {
+        const Player& p = players[i];
+        playerBoxX[i] = p.x; playerBoxY[i] = p.y;
+        playerBoxW[i] = p.width; playerBoxH[i] = p.height;
+    } else {
+        playerBoxX[i] = playerBoxY[i] = AabbBatch::FAR;
+        playerBoxW[i] = playerBoxH[i] = 0;
+    }
+}
+
+void Game::sweepProjectile(size_t i, std::vector<Uint16>& scratch, ProjectileHit& hit) const {
+    float pw = projectiles.w[i], ph = projectiles.h[i];
+    float bx = projectiles.x[i] - pw/2, by = projectiles.y[i] - ph/2; // Box is centered
+    float dx = projectiles.vx[i], dy = projectiles.vy[i];
+
+    hit.time = sweepPlatforms(bx, by, pw, ph, dx, dy, level, scratch, hit.wall);
+
+    // Earliest player along the path, unless a platform is in the way first
+    // (the swept area grows by a pixel so players it only touches at the end are swept too)
+    hit.target = -1;
+    float nx, ny;
+    uint64_t mask[AabbBatch::maskWords(PLAYER_LANES)];
+    AabbBatch::overlaps((dx < 0 ? bx + dx : bx) - 1, (dy < 0 ? by + dy : by) - 1,
+                        pw + std::abs(dx) + 2, ph + std::abs(dy) + 2, playerBoxes(), mask);
+    AabbBatch::forEachHit(mask, PLAYER_LANES, [&](size_t pi) {
+        const Player& player = players[pi];
+        // Don't hit self
+        if ((player.id - 1) == projectiles.owner[i] || player.invincible != 0) return;
+        // Already overlapping is an immediate hit (the player moved into it this tick)
+        float t = sweepAABB(bx, by, pw, ph, dx, dy, player.x, player.y, player.width, player.height, nx, ny);
+        if (t >= 0 && (t < hit.time || (hit.target < 0 && t == hit.time))) {
+            hit.time = t;
+            hit.target = static_cast<int>(pi);
+        }
+    });
+}
+
+void Game::resolvePlayerCollision(Player& a, Player& b) {
+    if (!checkCollision(a.x, a.y, a.width, a.height, b.x, b.y, b.width, b.height)) return;
+    if (a.invincible != 0 || b.invincible != 0) return;
+
+    // Bounce back
+    float knockback = GameConstants::KNOCKBACK_FORCE;
+    if (a.x < b.x) {
+        a.vx = -knockback; b.vx = knockback;
+    } else {
+        a.vx = knockback; b.vx = -knockback;
+    }
+    // Deal damage
+    float aDamage = GameConstants::COLLISION_DAMAGE;
+    float bDamage = GameConstants::COLLISION_DAMAGE;
+    DamageSource aSource = DAMAGE_COLLISION, bSource = DAMAGE_COLLISION;
+
+    // Ramming Logic (Rhino)
+    const AbilityDef& aAbility = ability(a.power);
+    const AbilityDef& bAbility = ability(b.power);
+    bool aRhino = aAbility.rams;
+    bool bRhino = bAbility.rams;
+    
+    // Check for Attacking (Any active attack: Fire, Dash, Lunge)
+    // Rhino is attacking if cooldown is active OR moving faster than normal max speed (Charging)
+    bool aAttacking = a.attackCooldown > 0 || (aRhino && std::abs(a.vx) > GameConstants::MAX_VELOCITY_X);
+    bool bAttacking = b.attackCooldown > 0 || (bRhino && std::abs(b.vx) > GameConstants::MAX_VELOCITY_X);
+
+    if (aRhino && bRhino) {
+        if (aAttacking && bAttacking) {
+            // CLASH! Both lose power
+            a.losePower();
+            b.losePower();
+            aDamage = 0; bDamage = 0;
+            // Visual effect
+            GameEvent e = {};
+            e.type = GameEvent::CLASH;
+            e.x = static_cast<Sint16>(a.x + a.width);
+            e.y = static_cast<Sint16>(a.y + a.height/2);
+            frameEvents.push_back(e);
+        } else {
+            // Just bumping into each other
+            aDamage = 0; bDamage = 0;
+        }
+    }
+    else if (aRhino) {
+        if (bAttacking && !aAttacking) {
+            // Counter! B attacks Passive Rhino -> Rhino loses power
+            a.losePower();
+            aDamage = 0; // Rhino takes no HP damage from the hit that breaks shield
+        }
+        
+        if (aAttacking) {
+            // Rhino Charge! B takes double damage
+            bDamage *= aAbility.ramDamageMultiplier;
+            bSource = DAMAGE_RAM;
+            aDamage = 0; // Rhino takes no damage while charging
+        } else if (!bAttacking) {
+             // Passive Rhino bump
+             aDamage = 0;
+        }
+    }
+    else if (bRhino) {
+        if (aAttacking && !bAttacking) {
+            // Counter! A attacks Passive Rhino -> Rhino loses power
+            b.losePower();
+            bDamage = 0;
+        }
+        
+        if (bAttacking) {
+            // Rhino Charge! A takes double damage
+            aDamage *= bAbility.ramDamageMultiplier;
+            aSource = DAMAGE_RAM;
+            bDamage = 0;
+        } else if (!aAttacking) {
+            // Passive Rhino bump
+            bDamage = 0;
+        }
+    }
+    else {
+        // Normal vs Normal
+        if (aAttacking && !bAttacking) {
+            // A Hits B
+            aDamage = 0;
+            bDamage = GameConstants::COLLISION_DAMAGE;
+        } else if (!aAttacking && bAttacking) {
+            // B Hits A
+            aDamage = GameConstants::COLLISION_DAMAGE;
+            bDamage = 0;
+        } else {
+            // Both Attacking (Clash) or Both Passive (Bump) -> Both take damage
+            aDamage = GameConstants::COLLISION_DAMAGE;
+            bDamage = GameConstants::COLLISION_DAMAGE;
+        }
+    }
+
+    a.takeDamage(aDamage, frameEvents, aSource);
+    b.takeDamage(bDamage, frameEvents, bSource);
+}
+
+int Game::alivePlayers() const {
+    int alive = 0;
+    for (const Player& p : players) if (p.hp > 0) alive++;
+    return alive;
+}
+
+int Game::decideWinner() const {
+    // Last one standing...
+    int last = 0;
+    for (const Player& p : players) if (p.hp > 0) last = p.id;
+    if (alivePlayers() <= 1) return last;
+
+    // ...else (time out) the unique highest HP
+    int best = 0;
+    float bestHp = 0;
+    for (const Player& p : players) {
+        if (p.hp > bestHp) { best = p.id; bestHp = p.hp; }
+        else if (p.hp == bestHp) best = 0;
     }
+    return best;
 }
 
 void Game::render() {
+    camera.beginFrame(renderAlpha); // This frame's view of the arena
     // Clear screen (Dark Slate Blue - High contrast    // Clear screen (Forest Green fallback)
     SDL_SetRenderDrawColor(renderer, 34, 139, 34, 255);
     SDL_RenderClear(renderer);
@@ -1183,20 +1894,13 @@ void Game::render() {
         // Dimming ("Little Blacky")
         SDL_SetTextureColorMod(backgroundTexture, 150, 150, 150); // Darken to ~60% brightness
 
-        // Parallax Effect
-        // Calculate average player position to shift background
-        float avgX = (players[0].x + players[1].x) / 2.0f;
-        float avgY = (players[0].y + players[1].y) / 2.0f;
-        
-        // Calculate offset (inverse to movement for depth)
-        // Max shift is small relative to screen size
-        float offsetX = (GameConstants::WINDOW_WIDTH / 2.0f - avgX) * 0.05f;
-        float offsetY = (GameConstants::WINDOW_HEIGHT / 2.0f - avgY) * 0.05f;
-
-        // Draw slightly larger than screen to cover edges during shift
+        // Parallax Effect: the backdrop (10% larger than the window) slides across
+        // its margin as the camera pans the arena, so it moves slower than the platforms
+        float panX = level.width() > camera.width ? camera.viewX / (level.width() - camera.width) : 0.5f;
+        float panY = level.height() > camera.height ? camera.viewY / (level.height() - camera.height) : 0.5f;
         SDL_Rect bgRect = {
-            static_cast<int>(-40 + offsetX),
-            static_cast<int>(-26 + offsetY),
+            static_cast<int>(-80 * clamp(panX, 0, 1)),
+            static_cast<int>(-52 * clamp(panY, 0, 1)),
             880, // 1.1x Width
             572  // 1.1x Height
         };
@@ -1211,6 +1915,8 @@ void Game::render() {
                 renderCenteredText(250, "Press H to HOST Game", {255, 255, 255, 255}, font);
                 renderCenteredText(300, "Press J to JOIN Game", {255, 255, 255, 255}, font);
                 renderCenteredText(350, "Press L for LOCAL Game", {200, 200, 200, 255}, font);
+                renderCenteredText(400, std::string("Press C for VS CPU (D: ") + Bot::difficultyName(botDifficulty) + ")",
+                                   {200, 200, 200, 255}, font);
                 
                 std::string seasonStr = (currentSeason == SEASON_GREEN) ? "Season: Forest" : "Season: Arctic";
                 renderCenteredText(450, "Press S to Change Season: " + seasonStr, {100, 255, 255, 255}, font);
@@ -1284,7 +1990,13 @@ void Game::render() {
 
             renderCenteredText(250, "Enter Friend's Code:", {255, 255, 255, 255}, font);
             renderCenteredText(300, inputText + "_", {0, 255, 255, 255}, font); // Input in Cyan
-            
+
+            // Relay Fallback Status
+            if (net.usingRelay) {
+                renderCenteredText(370, net.relayPaired ? "Connecting via Relay..." : "Direct Failed. Trying Relay...",
+                                   {255, 165, 0, 255}, font);
+            }
+
             renderCenteredText(450, "Share CODES via Message App", {150, 150, 150, 255}, font);
             renderCenteredText(500, "Then Press ENTER to Connect", {255, 255, 0, 255}, font);
         }
@@ -1340,10 +2052,10 @@ void Game::render() {
              renderCenteredText(500, "Press 'ENTER' or 'SPACE' to Toggle Ready", {200, 200, 200, 255}, font);
              
              if (p1Ready && p2Ready) {
-                  if (lobbyStartTimer > 0) {
+                  if (lobbyStartTicks > 0) {
                       // Countdown!
-                      std::string countStr = std::to_string((int)lobbyStartTimer);
-                      if (lobbyStartTimer > 0 && lobbyStartTimer < 1.0f) countStr = "GO!";
+                      std::string countStr = std::to_string(lobbyStartTicks / GameConstants::TICK_RATE);
+                      if (lobbyStartTicks < GameConstants::TICK_RATE) countStr = "GO!";
                       
                       // Draw BIG centered text
                       // Cheap way to make it big: Draw it multiple times with offsets or use titleFont
@@ -1364,20 +2076,28 @@ void Game::render() {
     }
 
     else if (currentState == PLAYING || currentState == PAUSED) {
-        // Draw Platforms
-        for (size_t i = 0; i < platforms.size(); ++i) {
-            const auto& p = platforms[i];
-            if (i == 0 && mudTileTexture) { // Ground Platform (Index 0)
+        // Everything in the arena is drawn shifted by the view and culled against it;
+        // the platforms on screen come from the level's collision grid
+        float viewX = camera.viewX, viewY = camera.viewY;
+        level.collisionGrid().query(viewX, viewY, camera.width, camera.height, visiblePlatforms);
+        for (Uint16 i : visiblePlatforms) {
+            const auto& p = level.platforms()[i];
+            if (!camera.sees(p.x, p.y, p.width, p.height)) continue;
+            float px = p.x - viewX, py = p.y - viewY;
+            if (level.tileLayer(i) == LevelFormat::LAYER_GROUND && mudTileTexture) { // Tiled ground
                 // Tile the texture
                 int tileW = 32; // Assuming 32x32 tile, adjust if needed
                 int tileH = 32;
                 SDL_QueryTexture(mudTileTexture, NULL, NULL, &tileW, &tileH);
-                
-                for (int x = p.x; x < p.x + p.width; x += tileW) {
-                    SDL_Rect destRect = { x, static_cast<int>(p.y), tileW, static_cast<int>(p.height) };
+
+                // Only the tiles on screen (tiling still starts at the platform's left edge)
+                float first = px + std::max(0, static_cast<int>(-px) / tileW) * tileW;
+                float last = std::min(px + p.width, camera.width);
+                for (float x = first; x < last; x += tileW) {
+                    SDL_Rect destRect = { static_cast<int>(x), static_cast<int>(py), tileW, static_cast<int>(p.height) };
                     // Clip the last tile if it exceeds platform width
-                    if (x + tileW > p.x + p.width) {
-                        destRect.w = static_cast<int>((p.x + p.width) - x);
+                    if (x + tileW > px + p.width) {
+                        destRect.w = static_cast<int>((px + p.width) - x);
                     }
                     SDL_RenderCopy(renderer, mudTileTexture, NULL, &destRect);
                 }
@@ -1386,7 +2106,7 @@ void Game::render() {
                 SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
                 SDL_SetRenderDrawColor(renderer, 200, 200, 255, 100); // Light Blue-ish White, Semi-transparent
 
-                SDL_Rect platformRect = { static_cast<int>(p.x), static_cast<int>(p.y), static_cast<int>(p.width), static_cast<int>(p.height) };
+                SDL_Rect platformRect = { static_cast<int>(px), static_cast<int>(py), static_cast<int>(p.width), static_cast<int>(p.height) };
                 SDL_RenderFillRect(renderer, &platformRect);
                 
                 // Optional: Add a subtle border for better visibility
@@ -1397,39 +2117,47 @@ void Game::render() {
             }
         }
         // Draw Power-ups (with bobbing effect)
-        for (const auto& pu : powerUps) {
-            // Assuming drawPowerUp function exists or similar logic
-            // For now, just draw a rect
-            drawRect(renderer, pu.x, pu.y, pu.width, pu.height, {255, 215, 0, 255});
+        for (size_t i = 0; i < powerUps.size(); ++i) {
+            float px = lerp(powerUps.prevX[i], powerUps.x[i], renderAlpha);
+            float py = lerp(powerUps.prevY[i], powerUps.y[i], renderAlpha);
+            if (!camera.sees(px, py - 5, powerUps.w[i], powerUps.h[i] + 10)) continue; // Bob range included
+            float bob = -cos((powerUps.timer[i] + renderAlpha) * 0.1f) * 5.0f;
+            drawRect(renderer, px - viewX, py + bob - viewY, powerUps.w[i], powerUps.h[i], {255, 215, 0, 255});
         }
 
-        // Draw Players
-        for (auto& player : players) player.render(renderer);
+        // Draw Players (with the power indicator above the head)
+        for (auto& player : players) {
+            if (player.hp > 0 && camera.sees(player.x, player.y - 10, player.width, player.height + 10, 20)) {
+                player.render(renderer, renderAlpha, viewX, viewY);
+            }
+        }
 
         // Draw Projectiles
-        for (const auto& p : projectiles) {
-            drawCircle(renderer, p.x, p.y, 5, {255, 255, 0, 255});
-        }
-        // Draw Particles
-        for (const auto& p : particles) {
-            drawRect(renderer, p.x, p.y, 3, 3, p.color);
+        for (size_t i = 0; i < projectiles.size(); ++i) {
+            float px = lerp(projectiles.prevX[i], projectiles.x[i], renderAlpha);
+            float py = lerp(projectiles.prevY[i], projectiles.y[i], renderAlpha);
+            if (camera.sees(px - 5, py - 5, 10, 10)) drawCircle(renderer, px - viewX, py - viewY, 5, {255, 255, 0, 255});
         }
+        // Draw Particles (one batched draw of the ones on screen)
+        particles.render(renderer, renderAlpha, viewX, viewY, camera.width, camera.height);
 
         // HUD: Timer & Health Bars
         if (font) {
-            // Timer
-            std::string timeStr = "Time: " + std::to_string((int)gameTime);
-            renderText(350, 20, timeStr, {255, 255, 255, 255}, font);
-
-            // P1 Health Bar
-            drawRect(renderer, 20, 20, 200, 20, {100, 0, 0, 255}); // Back
-            drawRect(renderer, 20, 20, (int)(players[0].hp * 2), 20, {0, 255, 0, 255}); // Front
-            renderText(20, 45, players[0].name, {255, 255, 255, 255}, font);
-
-            // P2 Health Bar
-            drawRect(renderer, 580, 20, 200, 20, {100, 0, 0, 255}); // Back
-            drawRect(renderer, 580, 20, (int)(players[1].hp * 2), 20, {0, 255, 0, 255}); // Front
-            renderText(580, 45, players[1].name, {255, 255, 255, 255}, font);
+            // Timer (below the bars once they span the screen)
+            int n = static_cast<int>(players.size());
+            std::string timeStr = "Time: " + std::to_string(gameTicks / GameConstants::TICK_RATE);
+            renderText(350, n > 2 ? 70 : 20, timeStr, {255, 255, 255, 255}, font);
+
+            // Health Bars, spread from the left edge (P1) to the right edge (last player)
+            int barW = n <= 2 ? 200 : std::min(200, 760 / n - 10);
+            int spacing = n > 1 ? (760 - barW) / (n - 1) : 0;
+            for (int i = 0; i < n; ++i) {
+                const Player& p = players[i];
+                int bx = 20 + i * spacing;
+                drawRect(renderer, bx, 20, barW, 20, {100, 0, 0, 255}); // Back
+                drawRect(renderer, bx, 20, (int)(std::max(0.0f, p.hp) * barW / p.maxHp), 20, {0, 255, 0, 255}); // Front
+                renderText(bx, 45, p.name, {255, 255, 255, 255}, font);
+            }
         }
     }
 
@@ -1442,7 +2170,7 @@ void Game::render() {
             renderText(350, 250, "PAUSED", {255, 255, 255, 255}, font);
             renderText(250, 300, "Quit to Menu? (Y/N)", {255, 255, 0, 255}, font);
             
-            std::string autoEnd = "Auto-End in: " + std::to_string((int)pauseTime);
+            std::string autoEnd = "Auto-End in: " + std::to_string(pauseTicks / GameConstants::TICK_RATE);
             renderText(300, 350, autoEnd, {255, 0, 0, 255}, font);
         }
     }
@@ -1453,8 +2181,7 @@ void Game::render() {
         
         if (font) {
             std::string winner;
-            if (winnerId == 1 && players.size() > 0) winner = players[0].name + " Wins!";
-            else if (winnerId == 2 && players.size() > 1) winner = players[1].name + " Wins!";
+            if (winnerId > 0 && winnerId <= static_cast<int>(players.size())) winner = players[winnerId - 1].name + " Wins!";
             else winner = "It's a Draw!";
             
             renderCenteredText(300, winner, {255, 255, 255, 255}, font);
@@ -1486,6 +2213,7 @@ void Game::renderCenteredText(int y, const std::string& text, SDL_Color color, T
 }
 
 void Game::cleanup() {
+    if (headless) return; // SDL was never started
     if (boyTexture) SDL_DestroyTexture(boyTexture);
     if (girlTexture) SDL_DestroyTexture(girlTexture);
     if (boyDragonTexture) SDL_DestroyTexture(boyDragonTexture);
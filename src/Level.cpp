@@ -0,0 +1,191 @@
+#include "Level.h"
+#include "Constants.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(Platform) == sizeof(LevelFormat::Rect),
+              "Platforms are read in place from level files");
+
+bool Level::load(const char* path) {
+    unload();
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(LevelFormat::Header))) {
+        close(fd);
+        return false;
+    }
+    void* mem = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) return false;
+    mapping = mem;
+    mappingSize = static_cast<size_t>(st.st_size);
+    if (!attach(static_cast<const Uint8*>(mem), mappingSize, path)) {
+        unload();
+        return false;
+    }
+    return true;
+#else
+    // No mmap: one read into a buffer, then the same in-place access
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    std::streamsize len = file.tellg();
+    if (len < static_cast<std::streamsize>(sizeof(LevelFormat::Header))) return false;
+    owned.resize(static_cast<size_t>(len));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(owned.data()), len) || !attach(owned.data(), owned.size(), path)) {
+        unload();
+        return false;
+    }
+    return true;
+#endif
+}
+
+void Level::loadDefault() {
+    unload();
+    using namespace LevelFormat;
+    Builder b;
+    b.name = "Classic";
+    b.width = GameConstants::WINDOW_WIDTH;
+    b.height = GameConstants::WINDOW_HEIGHT;
+    b.platforms.assign(std::begin(BakedArenas::CLASSIC), std::end(BakedArenas::CLASSIC));
+    b.layers = {LAYER_GROUND, LAYER_GLASS, LAYER_GLASS, LAYER_GLASS, LAYER_GLASS, LAYER_GLASS};
+    b.spawns = {
+        {100, 400, 0, SPAWN_START, {0, 0}}, {700, 400, 1, SPAWN_START, {0, 0}},
+        {100, 100, 0, SPAWN_RESPAWN, {0, 0}}, {700, 100, 1, SPAWN_RESPAWN, {0, 0}},
+        {250, 300, 2, SPAWN_START, {0, 0}}, {550, 300, 3, SPAWN_START, {0, 0}},
+        {250, 100, 2, SPAWN_RESPAWN, {0, 0}}, {550, 100, 3, SPAWN_RESPAWN, {0, 0}}
+    };
+    // Crates sit just above each platform, anywhere along it
+    for (const Rect& p : b.platforms) b.zones.push_back({p.x, p.y - 30, p.w - 30, 1});
+
+    owned = b.build();
+    attach(owned.data(), owned.size(), "built-in");
+}
+
+void Level::unload() {
+#ifndef _WIN32
+    if (mapping) munmap(mapping, mappingSize);
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    owned.clear();
+    header = nullptr;
+    platformData = nullptr;
+    layerData = nullptr;
+    spawnData = nullptr;
+    zoneData = nullptr;
+    boxX.clear();
+    boxY.clear();
+    boxW.clear();
+    boxH.clear();
+    baked = nullptr;
+    zoneCumulative.clear();
+    zoneTotal = 0;
+}
+
+bool Level::attach(const Uint8* data, size_t size, const char* source) {
+    using namespace LevelFormat;
+    const Header* h = reinterpret_cast<const Header*>(data);
+
+    // A section is valid if it is aligned and lies entirely inside the file
+    auto sectionOk = [&](Uint32 offset, Uint32 count, size_t itemSize) {
+        return count <= MAX_ITEMS && offset % 4 == 0 && offset >= sizeof(Header) &&
+               offset + static_cast<size_t>(count) * itemSize <= size;
+    };
+
+    const char* error = nullptr;
+    if (memcmp(h->magic, MAGIC, 4) != 0) error = "not a level file";
+    else if (h->version != VERSION || h->headerSize != sizeof(Header)) error = "unsupported version";
+    else if (h->fileSize != size) error = "truncated";
+    else if (LevelFormat::checksum(data + sizeof(Header), size - sizeof(Header)) != h->checksum) error = "checksum mismatch";
+    else if (!(h->width > 0) || !(h->height > 0)) error = "bad arena size";
+    else if (h->name[sizeof(h->name) - 1] != '\0') error = "bad name";
+    else if (h->platformCount == 0 || !sectionOk(h->platformOffset, h->platformCount, sizeof(Rect)) ||
+             h->layerOffset < sizeof(Header) || h->layerOffset + h->platformCount > size ||
+             !sectionOk(h->spawnOffset, h->spawnCount, sizeof(Spawn)) ||
+             !sectionOk(h->zoneOffset, h->zoneCount, sizeof(Zone))) error = "bad section table";
+    else {
+        // Power-up zones are picked from the running sum of their weights (32 bits)
+        const Zone* zones = reinterpret_cast<const Zone*>(data + h->zoneOffset);
+        Uint64 total = 0;
+        for (Uint32 i = 0; i < h->zoneCount && !error; ++i) {
+            total += zones[i].weight;
+            if (zones[i].weight == 0 || total > UINT32_MAX) error = "bad zone weights";
+        }
+    }
+    if (error) {
+        std::cerr << "Level: " << source << ": " << error << std::endl;
+        return false;
+    }
+
+    header = h;
+    platformData = reinterpret_cast<const Platform*>(data + h->platformOffset);
+    layerData = data + h->layerOffset;
+    spawnData = reinterpret_cast<const Spawn*>(data + h->spawnOffset);
+    zoneData = reinterpret_cast<const Zone*>(data + h->zoneOffset);
+
+    // Static collision grid
+    grid.init(0, 0, h->width, h->height, GameConstants::BROADPHASE_CELL);
+    for (Uint32 i = 0; i < h->platformCount; ++i) {
+        const Platform& p = platformData[i];
+        grid.insert(static_cast<Uint16>(i), p.x, p.y, p.width, p.height);
+    }
+
+    // Packed columns for the batch kernels
+    size_t padded = AabbBatch::paddedCount(h->platformCount);
+    boxX.assign(padded, AabbBatch::FAR);
+    boxY.assign(padded, AabbBatch::FAR);
+    boxW.assign(padded, 0.0f);
+    boxH.assign(padded, 0.0f);
+    for (Uint32 i = 0; i < h->platformCount; ++i) {
+        boxX[i] = platformData[i].x;
+        boxY[i] = platformData[i].y;
+        boxW[i] = platformData[i].width;
+        boxH[i] = platformData[i].height;
+    }
+    baked = BakedArenas::find(platformData, h->platformCount);
+
+    // Spawn table for power-ups
+    zoneCumulative.resize(h->zoneCount);
+    zoneTotal = 0;
+    for (Uint32 i = 0; i < h->zoneCount; ++i) {
+        zoneTotal += zoneData[i].weight;
+        zoneCumulative[i] = zoneTotal;
+    }
+    return true;
+}
+
+bool Level::spawnPoint(int player, LevelFormat::SpawnKind kind, float& x, float& y) const {
+    for (Uint32 i = 0; i < header->spawnCount; ++i) {
+        const LevelFormat::Spawn& s = spawnData[i];
+        if (s.player == player && s.kind == kind) {
+            x = s.x;
+            y = s.y;
+            return true;
+        }
+    }
+    return false;
+}
+
+const LevelFormat::Zone& Level::pickPowerUpZone(Uint32 random) const {
+    Uint32 r = random % zoneTotal;
+    // First zone whose running weight passes r (binary search)
+    size_t lo = 0, hi = zoneCumulative.size() - 1;
+    for (; lo < hi; ) {
+        size_t mid = (lo + hi) / 2;
+        if (zoneCumulative[mid] > r) hi = mid;
+        else lo = mid + 1;
+    }
+    return zoneData[lo];
+}
@@ -1,12 +1,11 @@
 #include "Player.h"
 #include "Constants.h"
 #include "Utils.h"
+#include "Abilities.h"
 #include <cmath>
 #include <algorithm>
 
-Player::Player() : id(0), x(0), y(0), vx(0), vy(0), width(0), height(0), hp(100), maxHp(100),
-           onGround(false), facing(1), powerTimer(0), invincible(0),
-           keyLeft(false), keyRight(false), keyJump(false), keyAttack(false),
+Player::Player() : color({255, 255, 255, 255}),
            texture(nullptr), normalTexture(nullptr), dragonTexture(nullptr), rhinoTexture(nullptr) {}
 
 void Player::init(int id, float x, float y, SDL_Color color, std::string name, 
@@ -15,6 +14,8 @@ void Player::init(int id, float x, float y, SDL_Color color, std::string name,
     this->id = id;
     this->x = x;
     this->y = y;
+    prevX = x;
+    prevY = y;
     width = 40;
     height = 50;
     this->color = color;
@@ -32,39 +33,58 @@ void Player::init(int id, float x, float y, SDL_Color color, std::string name,
     hp = 100;
     onGround = false;
     facing = (id == 1) ? 1 : -1; // P1 faces right, P2 faces left
-    power = "";
+    power = POWER_NONE;
     powerTimer = 0;
     invincible = 0;
-    keyLeft = false; keyRight = false; keyJump = false; keyAttack = false;
+    keyLeft = false; keyRight = false; keyJump = false; keyAttack = false; keyDown = false;
+    renderOffsetX = 0; renderOffsetY = 0;
     currentFrame = 0; frameTimer = 0; animRow = 0; attackCooldown = 0;
+    std::fill(damageTaken, damageTaken + DAMAGE_SOURCE_COUNT, 0.0f);
 }
 
-void Player::takeDamage(float damage, std::vector<Particle>& particles) {
+void Player::takeDamage(float damage, std::vector<GameEvent>& events, DamageSource source) {
     if (invincible > 0) return; // Ignore damage if invincible
     
     // Mario-Style Logic: Lose power-up instead of HP
-    if (power != "" && power != "health") {
-        power = ""; // Lose the power
-        texture = normalTexture; // Revert to normal sprite (e.g. from Dragon)
+    if (ability(power).absorbsHit) {
+        losePower(); // Revert to normal sprite (e.g. from Dragon)
         
         // Visual feedback
-        createParticles(particles, x + width/2, y + height/2, {0, 191, 255, 255}, 15); // Blue/Magic particles
+        emitEvent(events, GameEvent::POWER_LOST); // Blue/Magic particles
         invincible = 60; // Brief invincibility (1 second)
         return; // NO DAMAGE TAKEN
     }
 
     hp -= damage;
-    createHitParticles(particles);
+    damageTaken[source] += damage;
+    emitEvent(events, GameEvent::HIT);
 }
 
-void Player::createHitParticles(std::vector<Particle>& particles) {
-    createParticles(particles, x + width/2, y + height/2,
-                   {255, 0, 0, 255}, GameConstants::HIT_PARTICLE_COUNT);
+void Player::losePower() {
+    power = POWER_NONE;
+    texture = normalTexture;
 }
 
-void Player::update(const std::vector<Platform>& platforms,
-            std::vector<Projectile>& projectiles,
-            std::vector<Particle>& particles) {
+void Player::selectTexture() {
+    switch (ability(power).sprite) {
+        case SPRITE_DRAGON: texture = dragonTexture; break;
+        case SPRITE_RHINO:  texture = rhinoTexture; break;
+        default:            texture = normalTexture; break;
+    }
+}
+
+void Player::emitEvent(std::vector<GameEvent>& events, Uint8 type) const {
+    GameEvent e = {};
+    e.type = type;
+    e.arg = static_cast<Uint8>(id - 1);
+    e.x = static_cast<Sint16>(x + width/2);
+    e.y = static_cast<Sint16>(y + height/2);
+    events.push_back(e);
+}
+
+void Player::update(const Level& level,
+            EntityStore& projectiles,
+            std::vector<GameEvent>& events) {
     // ============================================================
     // 1. Input Handling
     // ============================================================
@@ -100,7 +120,8 @@ void Player::update(const std::vector<Platform>& platforms,
 
     // Advance animation frame
     // Advance animation frame
-    if (power == "fire" && !onGround) {
+    const AbilityDef& ab = ability(power);
+    if (ab.flies && !onGround) {
         currentFrame = 1; // Static flight frame
         frameTimer = 0;
     } else {
@@ -116,14 +137,14 @@ void Player::update(const std::vector<Platform>& platforms,
     // ============================================================
     // Clamp horizontal speed
 
-    float maxSpeed = (power == "shield") ? GameConstants::MAX_VELOCITY_X * GameConstants::RHINO_SPEED_MULTIPLIER : GameConstants::MAX_VELOCITY_X;
+    float maxSpeed = GameConstants::MAX_VELOCITY_X * ab.maxSpeedMultiplier;
     vx = clamp(vx, -maxSpeed, maxSpeed);
     // Apply friction (slow down when no input)
     vx *= GameConstants::FRICTION;
 
     // Jumping / Flying
     if (keyJump) {
-        if (power == "fire") {
+        if (ab.flies) {
             // Dragon Flight: Levitate upwards against gravity
             vy = -5.0f; // Constant upward speed
             onGround = false;
@@ -138,46 +159,35 @@ void Player::update(const std::vector<Platform>& platforms,
     // 4. Combat & Abilities
     // ============================================================
     // Texture Switching based on Power-up
-    if (power == "fire") {
-        texture = dragonTexture;
-    } else if (power == "shield") {
-        texture = rhinoTexture;
-    } else {
-        texture = normalTexture;
-    }
+    selectTexture();
 
     if (keyAttack && attackCooldown <= 0) {
-        if (power == "fire") {
-            projectiles.push_back({
-                x + (facing > 0 ? width : 0),
-                y + height / 2,
-                facing * GameConstants::PROJECTILE_SPEED,
-                0,
-                15, 15,
-                id - 1, // Owner ID (0 or 1)
-                "fire"
-            });
-            attackCooldown = GameConstants::FIRE_COOLDOWN;
-        }
-        else if (power == "shield") {
-            vx = facing * GameConstants::SPEED_BOOST; // Charge
-            createParticles(particles, x + width/2, y + height/2, color, 10);
-            attackCooldown = GameConstants::SPEED_COOLDOWN;
-        }
-        else {
-            // Basic Attack (Lunge)
-            vx = facing * 3.0f;
-            attackCooldown = 30; // 0.5s cooldown
+        switch (ab.attack) {
+            case ATTACK_PROJECTILE: {
+                if (projectiles.size() >= static_cast<size_t>(GameConstants::MAX_PROJECTILES)) break;
+                size_t p = projectiles.add(x + (facing > 0 ? width : 0), y + height / 2,
+                                           GameConstants::PROJECTILE_SIZE, GameConstants::PROJECTILE_SIZE,
+                                           power);
+                projectiles.vx[p] = facing * ab.attackSpeed;
+                projectiles.owner[p] = static_cast<Sint8>(id - 1); // Owner index
+                emitEvent(events, GameEvent::PROJECTILE_SPAWN);
+                break;
+            }
+            case ATTACK_CHARGE:
+                vx = facing * ab.attackSpeed; // Charge
+                emitEvent(events, GameEvent::CHARGE);
+                break;
+            case ATTACK_LUNGE:
+                vx = facing * ab.attackSpeed; // Basic Attack
+                break;
         }
+        attackCooldown = ab.attackCooldown;
     }
 
     // Update timers
     if (powerTimer > 0) {
         powerTimer--;
-        if (powerTimer <= 0) {
-            power = "";
-            texture = normalTexture;
-        }
+        if (powerTimer <= 0) losePower();
     }
     if (attackCooldown > 0) attackCooldown--;
     if (invincible > 0) invincible--;
@@ -185,7 +195,7 @@ void Player::update(const std::vector<Platform>& platforms,
     // ============================================================
     // 5. Physics Integration & Collision
     // ============================================================
-    if (power == "fire" && !onGround && !keyJump && !keyDown) {
+    if (ability(power).flies && !onGround && !keyJump && !keyDown) {
         // Gliding logic: Reduced gravity and terminal velocity
         vy += GameConstants::GRAVITY * 0.1f;
         if (vy > 2.0f) vy = 2.0f;
@@ -193,57 +203,85 @@ void Player::update(const std::vector<Platform>& platforms,
         vy += GameConstants::GRAVITY;
     }
 
+    // Each axis is swept: the move stops at the first platform it would touch,
+    // so fast charges and falls can't skip through thin platforms.
+    int hit;
+
     // Move X Axis
-    x += vx;
-    // Check X Collision
-    for (const auto& platform : platforms) {
-        if (checkCollision(x, y, width, height, platform.x, platform.y, platform.width, platform.height)) {
-            if (vx > 0) { // Moving right -> Hit left side of platform
-                x = platform.x - width;
-            } else if (vx < 0) { // Moving left -> Hit right side of platform
-                x = platform.x + platform.width;
-            }
-            vx = 0;
-        }
+    sweepPlatforms(x, y, width, height, vx, 0, level, nearbyPlatforms, hit);
+    if (hit >= 0) {
+        stopAt(level.platforms()[hit], vx, 0);
+    } else {
+        x += vx;
     }
 
     // Move Y Axis
-    y += vy;
     onGround = false;
-    // Check Y Collision
-    for (const auto& platform : platforms) {
-        if (checkCollision(x, y, width, height, platform.x, platform.y, platform.width, platform.height)) {
-            if (vy > 0) { // Falling down -> Land on top
-                y = platform.y - height;
-                onGround = true;
-                vy = 0;
-            } else if (vy < 0) { // Jumping up -> Hit bottom
-                y = platform.y + platform.height;
-                vy = 0;
-            }
-        }
+    sweepPlatforms(x, y, width, height, 0, vy, level, nearbyPlatforms, hit);
+    if (hit >= 0) {
+        stopAt(level.platforms()[hit], 0, vy);
+    } else {
+        y += vy;
     }
 
-    // Screen bounds
-    x = clamp(x, 0, GameConstants::WINDOW_WIDTH - width);
+    // Arena bounds
+    x = clamp(x, 0, level.width() - width);
     // Prevent flying off the top
     if (y < 0) {
         y = 0;
         vy = 0; // Stop upward velocity
     }
 
-    // Fall damage (falling off screen)
-    if (y > GameConstants::WINDOW_HEIGHT) {
-        takeDamage(GameConstants::FALL_DAMAGE, particles);
+    // Fall damage (falling out of the arena)
+    if (y > level.height()) {
+        takeDamage(GameConstants::FALL_DAMAGE, events, DAMAGE_FALL);
         // Respawn
-        y = 100;
-        x = (id == 1) ? 100 : 700;
+        if (!level.spawnPoint(id - 1, LevelFormat::SPAWN_RESPAWN, x, y)) {
+            y = 100;
+            x = (id % 2 == 1) ? 100 : 700;
+        }
+        vy = 0;
+        prevX = x; prevY = y; // Teleport, don't interpolate across the screen
+    }
+}
+
+void Player::stopAt(const Platform& platform, float dx, float dy) {
+    float nx, ny;
+    sweepAABB(x, y, width, height, dx, dy, platform.x, platform.y, platform.width, platform.height, nx, ny);
+    if (nx < 0) { // Left side
+        x = platform.x - width;
+        vx = 0;
+    } else if (nx > 0) { // Right side
+        x = platform.x + platform.width;
+        vx = 0;
+    } else if (ny < 0) { // Land on top
+        y = platform.y - height;
+        vy = 0;
+        onGround = true;
+    } else { // Bottom (head bump)
+        y = platform.y + platform.height;
         vy = 0;
     }
 }
 
-void Player::render(SDL_Renderer* renderer) const {
+Uint8 Player::getInputBits() const {
+    return (keyLeft ? 1 : 0) | (keyRight ? 2 : 0) | (keyJump ? 4 : 0) |
+           (keyDown ? 8 : 0) | (keyAttack ? 16 : 0);
+}
+
+void Player::setInputBits(Uint8 bits) {
+    keyLeft = bits & 1;
+    keyRight = bits & 2;
+    keyJump = bits & 4;
+    keyDown = bits & 8;
+    keyAttack = bits & 16;
+}
+
+void Player::render(SDL_Renderer* renderer, float alpha, float viewX, float viewY) const {
     SDL_Color playerColor = color;
+    // Draw position: interpolated between ticks, plus the prediction smoothing offset, on screen
+    float drawX = lerp(prevX, x, alpha) + renderOffsetX - viewX;
+    float drawY = lerp(prevY, y, alpha) + renderOffsetY - viewY;
 
     // Invincibility flash effect (flicker alpha)
     if (invincible > 0 && (invincible / 5) % 2 == 0) {
@@ -266,8 +304,8 @@ void Player::render(SDL_Renderer* renderer) const {
         };
         // Destination on screen
         SDL_Rect dstRect = {
-            static_cast<int>(x), 
-            static_cast<int>(y),
+            static_cast<int>(drawX), 
+            static_cast<int>(drawY),
             static_cast<int>(width), 
             static_cast<int>(height)
         };
@@ -277,15 +315,12 @@ void Player::render(SDL_Renderer* renderer) const {
         SDL_RenderCopyEx(renderer, texture, &srcRect, &dstRect, 0, NULL, flip);
     } else {
         // Fallback rectangle if texture fails
-        drawRect(renderer, x, y, width, height, playerColor, invincible > 0);
+        drawRect(renderer, drawX, drawY, width, height, playerColor, invincible > 0);
     }
 
     // Power-up indicator bar above head
-    if (power != "" && power != "health") {
-        SDL_Color powerColor;
-        if (power == "fire") powerColor = {255, 69, 0, 255};
-        else if (power == "shield") powerColor = {0, 191, 255, 255};
-
-        drawRect(renderer, x, y - 10, width, 5, powerColor);
+    const AbilityDef& ab = ability(power);
+    if (ab.showIndicator) {
+        drawRect(renderer, drawX, drawY - 10, width, 5, ab.indicatorColor);
     }
 }
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <cstring>
 #include <ctime>
+#include "Random.h"
 
 StunClient::StunClient() {
     // No internal socket
@@ -38,8 +39,14 @@ StunClient::StunResult StunClient::getPublicAddress(UDPsocket socket, const std:
     // Magic Cookie
     request[4] = 0x21; request[5] = 0x12; request[6] = 0xA4; request[7] = 0x42;
     
-    // Random Transaction ID
-    for(int i=8; i<20; ++i) request[i] = rand() % 255;
+    // Random Transaction ID (own stream: unrelated to any match)
+    thread_local Random rng;
+    thread_local bool seeded = false;
+    if (!seeded) {
+        rng.seed(Random::entropySeed(), 0);
+        seeded = true;
+    }
+    for(int i=8; i<20; ++i) request[i] = static_cast<Uint8>(rng.next());
 
     UDPpacket* packet = SDLNet_AllocPacket(512);
     memcpy(packet->data, request, 20);
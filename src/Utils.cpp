@@ -2,6 +2,7 @@
 #include "Constants.h"
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
 
 // Implementation of collision detection
 bool checkCollision(float x1, float y1, float w1, float h1,
@@ -17,26 +18,95 @@ bool checkCollision(float x1, float y1, float w1, float h1,
            y1 < y2 + h2 && y1 + h1 > y2;
 }
 
+float sweepAABB(float x1, float y1, float w1, float h1, float dx, float dy,
+                float x2, float y2, float w2, float h2, float& nx, float& ny) {
+    // Already inside (spawned there, knocked in, snapped by a reconcile): a hit right
+    // away, facing out through the shallowest side. Ties prefer the top.
+    if (checkCollision(x1, y1, w1, h1, x2, y2, w2, h2)) {
+        float up = y1 + h1 - y2, down = y2 + h2 - y1;
+        float left = x1 + w1 - x2, right = x2 + w2 - x1;
+        float depth = up;
+        nx = 0; ny = -1.0f;
+        if (down < depth) { depth = down; nx = 0; ny = 1.0f; }
+        if (left < depth) { depth = left; nx = -1.0f; ny = 0; }
+        if (right < depth) { nx = 1.0f; ny = 0; }
+        return 0.0f;
+    }
+
+    // Per axis: the move fractions at which the rects start and stop overlapping.
+    // With no motion on an axis they must already overlap on it (edges touching is not enough).
+    const float inf = 1e30f;
+    float entryX, exitX, entryY, exitY;
+    if (dx > 0) {
+        entryX = (x2 - (x1 + w1)) / dx; exitX = (x2 + w2 - x1) / dx;
+    } else if (dx < 0) {
+        entryX = (x2 + w2 - x1) / dx; exitX = (x2 - (x1 + w1)) / dx;
+    } else {
+        if (x1 + w1 <= x2 || x1 >= x2 + w2) return -1;
+        entryX = -inf; exitX = inf;
+    }
+    if (dy > 0) {
+        entryY = (y2 - (y1 + h1)) / dy; exitY = (y2 + h2 - y1) / dy;
+    } else if (dy < 0) {
+        entryY = (y2 + h2 - y1) / dy; exitY = (y2 - (y1 + h1)) / dy;
+    } else {
+        if (y1 + h1 <= y2 || y1 >= y2 + h2) return -1;
+        entryY = -inf; exitY = inf;
+    }
+
+    float entry = std::max(entryX, entryY);
+    float exit = std::min(exitX, exitY);
+    // entry < 0: moving away; entry >= exit: no common overlap
+    if (entry < 0 || entry > 1 || entry >= exit) return -1;
+
+    if (entryX > entryY) {
+        nx = dx > 0 ? -1.0f : 1.0f; ny = 0;
+    } else {
+        nx = 0; ny = dy > 0 ? -1.0f : 1.0f;
+    }
+    return entry;
+}
+
+float sweepPlatforms(float x, float y, float w, float h, float dx, float dy,
+                     const Level& level, std::vector<Uint16>& scratch, int& hit) {
+    if (level.bakedArena()) return level.bakedArena()->sweep(x, y, w, h, dx, dy, hit);
+    hit = -1;
+    // The swept area, grown by a pixel so boxes that only touch it at the end of
+    // the move are still swept (the same area on every path, baked ones included)
+    float sx = (dx < 0 ? x + dx : x) - 1, sy = (dy < 0 ? y + dy : y) - 1;
+    float sw = w + std::abs(dx) + 2, sh = h + std::abs(dy) + 2;
+    float toi = 1.0f;
+    float nx, ny;
+    auto test = [&](int pi) {
+        const Platform& p = level.platforms()[pi];
+        float t = sweepAABB(x, y, w, h, dx, dy, p.x, p.y, p.width, p.height, nx, ny);
+        if (t >= 0 && (t < toi || (t == toi && hit < 0))) { // Ties keep the lowest index
+            toi = t;
+            hit = pi;
+        }
+    };
+
+    if (level.platformCount() <= GameConstants::BATCH_SCAN_PLATFORMS) {
+        // Small arena: one batch pass over every platform
+        uint64_t mask[(GameConstants::BATCH_SCAN_PLATFORMS + 63) / 64];
+        AabbBatch::Boxes boxes = level.platformBoxes();
+        AabbBatch::overlaps(sx, sy, sw, sh, boxes, mask);
+        AabbBatch::forEachHit(mask, boxes.count, [&](size_t pi) { test(static_cast<int>(pi)); });
+        return toi;
+    }
+
+    // Broadphase over the whole swept area
+    level.collisionGrid().query(sx, sy, sw, sh, scratch);
+    for (Uint16 pi : scratch) test(pi);
+    return toi;
+}
+
 float clamp(float value, float min, float max) {
     if (value < min) return min;
     if (value > max) return max;
     return value;
 }
 
-void createParticles(std::vector<Particle>& particles, float x, float y,
-                    SDL_Color color, int count) {
-    for (int i = 0; i < count; ++i) {
-        particles.push_back({
-            x, y,
-            // Random velocity between -4 and 4
-            (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 8,
-            (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 8,
-            GameConstants::PARTICLE_LIFETIME,
-            color
-        });
-    }
-}
-
 void drawRect(SDL_Renderer* renderer, float x, float y, float w, float h,
              SDL_Color color, bool blend) {
     if (blend) {
@@ -77,23 +147,13 @@ void drawCircle(SDL_Renderer* renderer, int cx, int cy, int radius, SDL_Color co
     }
 }
 
-void spawnPowerUp(std::vector<PowerUp>& powerUps,
-                 const std::vector<Platform>& platforms) {
-    if (powerUps.size() >= GameConstants::MAX_POWER_UPS) return;
-
-    std::vector<std::string> types = {"fire", "shield", "health"};
-    std::string type = types[rand() % types.size()];
-    
-    // Pick a random platform to spawn on
-    const Platform& platform = platforms[rand() % platforms.size()];
+PowerUpSpawn rollPowerUp(const Level& level, Random& rng) {
+    PowerUpSpawn s;
+    s.type = static_cast<PowerType>(POWER_FIRE + rng.below(3)); // fire, shield or health
 
-    powerUps.push_back({
-        // Random X position on the platform
-        platform.x + (static_cast<float>(rand()) / RAND_MAX) * (platform.width - 30),
-        platform.y - 30, // Just above the platform
-        25, 25,
-        type,
-        0,
-        GameConstants::POWER_UP_LIFETIME
-    });
+    // Pick a zone from the level's spawn table, then a random spot along it
+    const LevelFormat::Zone& zone = level.pickPowerUpZone(rng.next());
+    s.x = zone.x + rng.unit() * zone.w;
+    s.y = zone.y;
+    return s;
 }
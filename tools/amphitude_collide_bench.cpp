@@ -0,0 +1,134 @@
+// amphitude-collide-bench: times the narrow phase, one box against many, the
+// old way (one checkCollision() call per pair) and with every AabbBatch kernel
+// this CPU runs, and checks that they all report the same hits.
+//
+// Usage: amphitude-collide-bench [--boxes N] [--queries Q] [--seed S]
+//
+// The scene is dense: N boxes of 8-64 px scattered over a 1280x720 arena, each
+// query a box from the same distribution, so about one pair in 200 overlaps.
+// Exit status is 1 if any kernel's mask differs from the per-pair test.
+
+#include "AabbBatch.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct Options {
+    size_t boxes = 4096;
+    size_t queries = 4096;
+    uint32_t seed = 1;
+};
+
+uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+float randomIn(uint32_t& state, float lo, float hi) {
+    return lo + (hi - lo) * ((nextRandom(state) >> 8) * (1.0f / 16777216.0f));
+}
+
+/** @brief checkCollision() as the game calls it: out of line, one pair per call. */
+__attribute__((noinline))
+bool checkPair(float x1, float y1, float w1, float h1, float x2, float y2, float w2, float h2) {
+    return x1 < x2 + w2 && x1 + w1 > x2 && y1 < y2 + h2 && y1 + h1 > y2;
+}
+
+size_t perPair(float x, float y, float w, float h, const AabbBatch::Boxes& b, uint64_t* mask) {
+    memset(mask, 0, AabbBatch::maskWords(b.count) * sizeof(uint64_t));
+    size_t hits = 0;
+    for (size_t i = 0; i < b.count; ++i) {
+        if (checkPair(x, y, w, h, b.x[i], b.y[i], b.w[i], b.h[i])) {
+            mask[i >> 6] |= uint64_t(1) << (i & 63);
+            ++hits;
+        }
+    }
+    return hits;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--boxes") && hasValue) opt.boxes = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--queries") && hasValue) opt.queries = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--seed") && hasValue) opt.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else return false;
+    }
+    return opt.boxes > 0 && opt.queries > 0 && opt.seed != 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        fprintf(stderr, "Usage: %s [--boxes N] [--queries Q] [--seed S]\n", argv[0]);
+        return 2;
+    }
+
+    // Scene as packed columns, padded the way Level pads its platforms
+    uint32_t rng = opt.seed;
+    size_t padded = AabbBatch::paddedCount(opt.boxes);
+    std::vector<float> x(padded, AabbBatch::FAR), y(padded, AabbBatch::FAR), w(padded, 0.0f), h(padded, 0.0f);
+    for (size_t i = 0; i < opt.boxes; ++i) {
+        w[i] = randomIn(rng, 8, 64);
+        h[i] = randomIn(rng, 8, 64);
+        x[i] = randomIn(rng, 0, 1280 - w[i]);
+        y[i] = randomIn(rng, 0, 720 - h[i]);
+    }
+    AabbBatch::Boxes boxes = {x.data(), y.data(), w.data(), h.data(), padded};
+    std::vector<float> query(opt.queries * 4);
+    for (size_t q = 0; q < opt.queries; ++q) {
+        query[q * 4 + 2] = randomIn(rng, 8, 64);
+        query[q * 4 + 3] = randomIn(rng, 8, 64);
+        query[q * 4 + 0] = randomIn(rng, 0, 1280 - query[q * 4 + 2]);
+        query[q * 4 + 1] = randomIn(rng, 0, 720 - query[q * 4 + 3]);
+    }
+
+    size_t words = AabbBatch::maskWords(padded);
+    std::vector<uint64_t> reference(opt.queries * words), mask(words);
+    double pairs = static_cast<double>(opt.boxes) * opt.queries;
+
+    // Baseline, which also records the expected masks
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    size_t baselineHits = 0;
+    for (size_t q = 0; q < opt.queries; ++q) {
+        const float* b = &query[q * 4];
+        baselineHits += perPair(b[0], b[1], b[2], b[3], boxes, &reference[q * words]);
+    }
+    double baselineNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / pairs;
+    printf("%zu boxes x %zu queries, %zu hits (%.2f%% of pairs)\n",
+           opt.boxes, opt.queries, baselineHits, 100.0 * baselineHits / pairs);
+    printf("%-10s %8.3f ns/pair\n", "per-pair", baselineNs);
+
+    int status = 0;
+    for (int k = 0; k < AabbBatch::KERNEL_COUNT; ++k) {
+        AabbBatch::Kernel kernel = static_cast<AabbBatch::Kernel>(k);
+        if (!AabbBatch::available(kernel)) continue;
+
+        size_t hits = 0;
+        bool same = true;
+        start = Clock::now();
+        for (size_t q = 0; q < opt.queries; ++q) {
+            const float* b = &query[q * 4];
+            hits += AabbBatch::overlaps(kernel, b[0], b[1], b[2], b[3], boxes, mask.data());
+            same = same && memcmp(mask.data(), &reference[q * words], words * sizeof(uint64_t)) == 0;
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / pairs;
+        printf("%-10s %8.3f ns/pair  %5.2fx%s\n", AabbBatch::kernelName(kernel), ns, baselineNs / ns,
+               kernel == AabbBatch::active() ? "  (active)" : "");
+        if (!same || hits != baselineHits) {
+            fprintf(stderr, "%s: masks differ from the per-pair test\n", AabbBatch::kernelName(kernel));
+            status = 1;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,141 @@
+// amphitude-levelc: compiles a text level description into the binary level format.
+//
+// Usage: amphitude-levelc <input.txt> <output.lvl>
+//
+// One directive per line, '#' starts a comment:
+//   name <text>                      Display name (up to 31 characters)
+//   size <width> <height>            Arena size in pixels
+//   platform <x> <y> <w> <h> [ground|glass]
+//   spawn <player> <start|respawn> <x> <y>   Player numbers start at 1
+//   zone <x> <y> <w> [weight]        Power-up strip (crate left edge in [x, x+w], top at y)
+//
+// The output is laid out exactly as the game uses it in memory (see LevelFormat.h).
+// A level named like a baked arena (see BakedArenas.h) must keep exactly the
+// baked platforms, so the two copies can't drift apart.
+
+#include "BakedArenas.h"
+#include "LevelFormat.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+bool fail(const char* file, int line, const std::string& msg) {
+    std::cerr << file << ":" << line << ": " << msg << std::endl;
+    return false;
+}
+
+bool parse(const char* path, LevelFormat::Builder& b) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+
+    std::string text;
+    int lineNo = 0;
+    uint64_t zoneTotal = 0;
+    for (; std::getline(in, text); ) {
+        lineNo++;
+        size_t hash = text.find('#');
+        if (hash != std::string::npos) text.erase(hash);
+
+        std::istringstream line(text);
+        std::string cmd;
+        if (!(line >> cmd)) continue; // Blank line
+
+        if (cmd == "name") {
+            std::getline(line >> std::ws, b.name);
+            if (b.name.empty() || b.name.size() > 31) return fail(path, lineNo, "name must be 1-31 characters");
+        } else if (cmd == "size") {
+            if (!(line >> b.width >> b.height) || b.width <= 0 || b.height <= 0)
+                return fail(path, lineNo, "expected: size <width> <height>");
+        } else if (cmd == "platform") {
+            LevelFormat::Rect r;
+            std::string layer = "glass";
+            if (!(line >> r.x >> r.y >> r.w >> r.h) || r.w <= 0 || r.h <= 0)
+                return fail(path, lineNo, "expected: platform <x> <y> <w> <h> [ground|glass]");
+            line >> layer;
+            if (layer != "ground" && layer != "glass") return fail(path, lineNo, "unknown layer '" + layer + "'");
+            b.platforms.push_back(r);
+            b.layers.push_back(layer == "ground" ? LevelFormat::LAYER_GROUND : LevelFormat::LAYER_GLASS);
+        } else if (cmd == "spawn") {
+            int player;
+            std::string kind;
+            LevelFormat::Spawn s = {};
+            if (!(line >> player >> kind >> s.x >> s.y) || player < 1 || player > 255 ||
+                (kind != "start" && kind != "respawn"))
+                return fail(path, lineNo, "expected: spawn <player> <start|respawn> <x> <y>");
+            s.player = static_cast<uint8_t>(player - 1);
+            s.kind = kind == "start" ? LevelFormat::SPAWN_START : LevelFormat::SPAWN_RESPAWN;
+            b.spawns.push_back(s);
+        } else if (cmd == "zone") {
+            LevelFormat::Zone z;
+            z.weight = 1;
+            if (!(line >> z.x >> z.y >> z.w) || z.w < 0)
+                return fail(path, lineNo, "expected: zone <x> <y> <w> [weight]");
+            if (!(line >> std::ws).eof()) {
+                long long weight;
+                if (!(line >> weight) || !(line >> std::ws).eof() || weight <= 0 || weight > UINT32_MAX)
+                    return fail(path, lineNo, "zone weight must be a positive integer");
+                z.weight = static_cast<uint32_t>(weight);
+            }
+            // The game picks zones from the running sum, which must fit in 32 bits
+            zoneTotal += z.weight;
+            if (zoneTotal > UINT32_MAX) return fail(path, lineNo, "zone weights add up to more than 2^32-1");
+            b.zones.push_back(z);
+        } else {
+            return fail(path, lineNo, "unknown directive '" + cmd + "'");
+        }
+    }
+
+    if (b.width <= 0) return fail(path, lineNo, "missing 'size'");
+    if (b.platforms.empty()) return fail(path, lineNo, "level has no platforms");
+    if (b.platforms.size() > LevelFormat::MAX_ITEMS || b.spawns.size() > LevelFormat::MAX_ITEMS ||
+        b.zones.size() > LevelFormat::MAX_ITEMS)
+        return fail(path, lineNo, "too many entries (limit " + std::to_string(LevelFormat::MAX_ITEMS) + ")");
+    if (b.name.empty()) b.name = "Untitled";
+
+    // The game also has this arena compiled in: both copies must agree
+    for (const BakedArenas::Table& t : BakedArenas::TABLES) {
+        if (b.name != t.name) continue;
+        bool same = b.platforms.size() == t.platformCount;
+        for (size_t i = 0; same && i < t.platformCount; ++i) {
+            const LevelFormat::Rect& a = b.platforms[i];
+            const LevelFormat::Rect& r = t.platforms[i];
+            same = a.x == r.x && a.y == r.y && a.w == r.w && a.h == r.h;
+        }
+        if (!same)
+            return fail(path, lineNo, "platforms differ from the baked '" + b.name +
+                                      "' arena; update include/BakedArenas.h too");
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.txt> <output.lvl>" << std::endl;
+        return 2;
+    }
+
+    LevelFormat::Builder builder;
+    if (!parse(argv[1], builder)) return 1;
+
+    std::vector<uint8_t> image = builder.build();
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    if (!out.write(reinterpret_cast<const char*>(image.data()), image.size())) {
+        std::cerr << "Cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << argv[2] << ": \"" << builder.name << "\", " << builder.platforms.size() << " platforms, "
+              << builder.spawns.size() << " spawns, " << builder.zones.size() << " zones, "
+              << image.size() << " bytes" << std::endl;
+    return 0;
+}
@@ -0,0 +1,385 @@
+// amphitude-relay: optional UDP relay for peers that cannot hole punch.
+//
+// Usage: amphitude-relay [port] [maxSessions]
+//
+// Peers register with a RelayProtocol::Control datagram. Once both peers of a
+// session are known, every other datagram is forwarded verbatim to the partner.
+// All tables are allocated once at startup and forwarding reuses the receive
+// buffers, so the hot path does no allocation. On Linux datagrams are received
+// and sent in batches with recvmmsg/sendmmsg (one syscall pair per batch).
+
+#include "RelayProtocol.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const int BATCH_SIZE = 64;          ///< Datagrams per recvmmsg/sendmmsg call
+const int MAX_DATAGRAM = 2048;      ///< Larger than any game Packet
+const uint32_t SESSION_IDLE_MS = 30000; ///< Sessions with no traffic are reclaimed
+const uint32_t REBIND_IDLE_MS = 5000;   ///< A side idle this long may be replaced (NAT rebinding)
+
+uint32_t nowMs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint32_t>(ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000ULL);
+}
+
+uint64_t addrKey(const sockaddr_in& a) {
+    return (static_cast<uint64_t>(a.sin_addr.s_addr) << 16) | a.sin_port;
+}
+
+/**
+ * @brief Fixed-capacity open-addressing map (uint64 -> uint32).
+ *
+ * Linear probing with backward-shift deletion, so there are no tombstones and
+ * lookups stay short under churn. Key 0 marks an empty slot.
+ */
+class FlatIndex {
+public:
+    explicit FlatIndex(size_t minCapacity) {
+        size_t cap = 16;
+        for (; cap < minCapacity * 2; ) cap <<= 1; // keep load factor <= 0.5
+        keys.assign(cap, 0);
+        values.assign(cap, 0);
+        mask = cap - 1;
+    }
+
+    bool find(uint64_t key, uint32_t& out) const {
+        for (size_t i = slot(key); ; i = (i + 1) & mask) {
+            if (keys[i] == 0) return false;
+            if (keys[i] == key) { out = values[i]; return true; }
+        }
+    }
+
+    void insert(uint64_t key, uint32_t value) {
+        for (size_t i = slot(key); ; i = (i + 1) & mask) {
+            if (keys[i] == 0 || keys[i] == key) {
+                keys[i] = key;
+                values[i] = value;
+                return;
+            }
+        }
+    }
+
+    void erase(uint64_t key) {
+        size_t i = slot(key);
+        for (; keys[i] != key; i = (i + 1) & mask) {
+            if (keys[i] == 0) return;
+        }
+        // Backward-shift following entries that would become unreachable
+        size_t hole = i;
+        for (size_t j = (hole + 1) & mask; keys[j] != 0; j = (j + 1) & mask) {
+            size_t home = slot(keys[j]);
+            bool movable = (hole <= j) ? (home <= hole || home > j) : (home <= hole && home > j);
+            if (movable) {
+                keys[hole] = keys[j];
+                values[hole] = values[j];
+                hole = j;
+            }
+        }
+        keys[hole] = 0;
+    }
+
+private:
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> values;
+    size_t mask;
+
+    size_t slot(uint64_t key) const {
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDULL;
+        key ^= key >> 33;
+        return static_cast<size_t>(key) & mask;
+    }
+};
+
+struct Session {
+    uint64_t id = 0;          ///< 0 = free slot
+    sockaddr_in side[2];
+    bool hasSide[2] = {false, false};
+    uint32_t lastSeen[2] = {0, 0};
+    uint32_t nextFree = 0;
+};
+
+/**
+ * @brief Session registry. All storage is sized at construction.
+ */
+class Relay {
+public:
+    explicit Relay(uint32_t maxSessions)
+        : sessions(maxSessions), bySession(maxSessions), byAddress(maxSessions * 2) {
+        for (uint32_t i = 0; i < maxSessions; ++i) sessions[i].nextFree = i + 1;
+        freeHead = 0;
+    }
+
+    /**
+     * @brief Handles a REGISTER. Returns the reply type to send back.
+     */
+    uint8_t registerPeer(uint64_t sessionId, const sockaddr_in& from, uint32_t now) {
+        if (sessionId == 0) return RelayProtocol::MSG_FULL;
+
+        uint32_t idx;
+        if (!bySession.find(sessionId, idx)) {
+            if (freeHead >= sessions.size()) return RelayProtocol::MSG_FULL;
+            idx = freeHead;
+            freeHead = sessions[idx].nextFree;
+            sessions[idx] = Session();
+            sessions[idx].id = sessionId;
+            bySession.insert(sessionId, idx);
+            activeSessions++;
+        }
+        Session& s = sessions[idx];
+
+        uint64_t key = addrKey(from);
+        uint32_t existing;
+        if (byAddress.find(key, existing) && existing / 2 == idx) {
+            s.lastSeen[existing % 2] = now;
+        } else {
+            int side = -1;
+            if (!s.hasSide[0]) side = 0;
+            else if (!s.hasSide[1]) side = 1;
+            else {
+                // Both taken: allow a peer whose NAT mapping changed to take over a stale side
+                int older = (s.lastSeen[0] <= s.lastSeen[1]) ? 0 : 1;
+                if (now - s.lastSeen[older] > REBIND_IDLE_MS) {
+                    byAddress.erase(addrKey(s.side[older]));
+                    side = older;
+                }
+            }
+            if (side < 0) return RelayProtocol::MSG_FULL;
+
+            if (byAddress.find(key, existing)) detach(key, existing); // Address moved sessions
+            s.side[side] = from;
+            s.hasSide[side] = true;
+            s.lastSeen[side] = now;
+            byAddress.insert(key, idx * 2 + side);
+        }
+        return (s.hasSide[0] && s.hasSide[1]) ? RelayProtocol::MSG_PAIRED : RelayProtocol::MSG_WAITING;
+    }
+
+    /**
+     * @brief Looks up where a data datagram from `from` should go.
+     *
+     * The partner address is copied out: a later registration in the same
+     * batch may re-pair the session before the batch is sent.
+     * @return False if the sender is unknown or unpaired.
+     */
+    bool route(const sockaddr_in& from, uint32_t now, sockaddr_in& to) {
+        uint32_t v;
+        if (!byAddress.find(addrKey(from), v)) return false;
+        Session& s = sessions[v / 2];
+        int side = v % 2;
+        s.lastSeen[side] = now;
+        if (!s.hasSide[1 - side]) return false;
+        forwarded++;
+        to = s.side[1 - side];
+        return true;
+    }
+
+    /** @brief Reclaims sessions where both sides went quiet. */
+    void sweep(uint32_t now) {
+        for (uint32_t i = 0; i < sessions.size(); ++i) {
+            Session& s = sessions[i];
+            if (s.id == 0) continue;
+            bool idle0 = !s.hasSide[0] || now - s.lastSeen[0] > SESSION_IDLE_MS;
+            bool idle1 = !s.hasSide[1] || now - s.lastSeen[1] > SESSION_IDLE_MS;
+            if (idle0 && idle1) release(i);
+        }
+    }
+
+    uint32_t activeSessions = 0;
+    uint64_t forwarded = 0;
+
+private:
+    std::vector<Session> sessions;
+    FlatIndex bySession;
+    FlatIndex byAddress; ///< value = sessionIndex * 2 + side
+    uint32_t freeHead;
+
+    void detach(uint64_t key, uint32_t v) {
+        Session& s = sessions[v / 2];
+        s.hasSide[v % 2] = false;
+        byAddress.erase(key);
+        if (!s.hasSide[0] && !s.hasSide[1]) release(v / 2);
+    }
+
+    void release(uint32_t idx) {
+        Session& s = sessions[idx];
+        for (int side = 0; side < 2; ++side) {
+            if (s.hasSide[side]) byAddress.erase(addrKey(s.side[side]));
+        }
+        bySession.erase(s.id);
+        s = Session();
+        s.nextFree = freeHead;
+        freeHead = idx;
+        activeSessions--;
+    }
+};
+
+/**
+ * @brief Preallocated batch of datagram slots shared by the receive and send paths.
+ */
+struct Batch {
+    char data[BATCH_SIZE][MAX_DATAGRAM];
+    RelayProtocol::Control replies[BATCH_SIZE];
+    sockaddr_in from[BATCH_SIZE];
+    sockaddr_in to[BATCH_SIZE];
+    int len[BATCH_SIZE];
+#ifdef __linux__
+    iovec recvIov[BATCH_SIZE];
+    mmsghdr recvMsgs[BATCH_SIZE];
+    iovec sendIov[BATCH_SIZE];
+    mmsghdr sendMsgs[BATCH_SIZE];
+#endif
+};
+
+int receiveBatch(int fd, Batch& b) {
+#ifdef __linux__
+    for (int i = 0; i < BATCH_SIZE; ++i) {
+        b.recvIov[i].iov_base = b.data[i];
+        b.recvIov[i].iov_len = MAX_DATAGRAM;
+        memset(&b.recvMsgs[i].msg_hdr, 0, sizeof(msghdr));
+        b.recvMsgs[i].msg_hdr.msg_iov = &b.recvIov[i];
+        b.recvMsgs[i].msg_hdr.msg_iovlen = 1;
+        b.recvMsgs[i].msg_hdr.msg_name = &b.from[i];
+        b.recvMsgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+    // Block for the first datagram, then take whatever else is already queued
+    int n = recvmmsg(fd, b.recvMsgs, BATCH_SIZE, MSG_WAITFORONE, nullptr);
+    for (int i = 0; i < n; ++i) b.len[i] = static_cast<int>(b.recvMsgs[i].msg_len);
+    return n;
+#else
+    socklen_t fromLen = sizeof(sockaddr_in);
+    ssize_t r = recvfrom(fd, b.data[0], MAX_DATAGRAM, 0, reinterpret_cast<sockaddr*>(&b.from[0]), &fromLen);
+    if (r < 0) return -1;
+    b.len[0] = static_cast<int>(r);
+    return 1;
+#endif
+}
+
+/** @brief Queued outgoing datagram (points into Batch storage, never owns memory). */
+struct Outgoing {
+    const void* data;
+    int len;
+    sockaddr_in to;
+};
+
+void sendBatch(int fd, Batch& b, const Outgoing* out, int count) {
+#ifdef __linux__
+    for (int i = 0; i < count; ++i) {
+        b.to[i] = out[i].to;
+        b.sendIov[i].iov_base = const_cast<void*>(out[i].data);
+        b.sendIov[i].iov_len = out[i].len;
+        memset(&b.sendMsgs[i].msg_hdr, 0, sizeof(msghdr));
+        b.sendMsgs[i].msg_hdr.msg_iov = &b.sendIov[i];
+        b.sendMsgs[i].msg_hdr.msg_iovlen = 1;
+        b.sendMsgs[i].msg_hdr.msg_name = &b.to[i];
+        b.sendMsgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+    for (int sent = 0; sent < count; ) {
+        int r = sendmmsg(fd, b.sendMsgs + sent, count - sent, 0);
+        if (r <= 0) {
+            if (r < 0 && errno == EINTR) continue;
+            sent++; // Skip the datagram the kernel refused (e.g. unreachable) and keep going
+            continue;
+        }
+        sent += r;
+    }
+#else
+    for (int i = 0; i < count; ++i) {
+        sendto(fd, out[i].data, out[i].len, 0, reinterpret_cast<const sockaddr*>(&out[i].to), sizeof(sockaddr_in));
+    }
+#endif
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int port = (argc > 1) ? atoi(argv[1]) : RelayProtocol::DEFAULT_PORT;
+    uint32_t maxSessions = (argc > 2) ? static_cast<uint32_t>(atoi(argv[2])) : 16384;
+    if (port <= 0 || port > 65535 || maxSessions == 0) {
+        std::cerr << "Usage: amphitude-relay [port] [maxSessions]" << std::endl;
+        return 1;
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return 1;
+    }
+    sockaddr_in bindAddr;
+    memset(&bindAddr, 0, sizeof(bindAddr));
+    bindAddr.sin_family = AF_INET;
+    bindAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+    bindAddr.sin_port = htons(static_cast<uint16_t>(port));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&bindAddr), sizeof(bindAddr)) < 0) {
+        perror("bind");
+        return 1;
+    }
+
+    // Larger kernel buffers absorb bursts from thousands of matches
+    int bufSize = 4 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufSize, sizeof(bufSize));
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufSize, sizeof(bufSize));
+    // Wake up at least once a second to reclaim idle sessions
+    timeval tv = {1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    Relay relay(maxSessions);
+    Batch* batch = new Batch(); // ~140 KB, keep it off the stack
+    Outgoing out[BATCH_SIZE];
+
+    std::cout << "amphitude-relay listening on UDP " << port
+              << " (" << maxSessions << " sessions)" << std::endl;
+
+    uint32_t lastSweep = nowMs();
+    uint32_t lastStats = lastSweep;
+    for (;;) {
+        int n = receiveBatch(fd, *batch);
+        uint32_t now = nowMs();
+
+        int outCount = 0;
+        for (int i = 0; i < n; ++i) {
+            const char* data = batch->data[i];
+            int len = batch->len[i];
+            if (RelayProtocol::isControl(data, len)) {
+                RelayProtocol::Control req;
+                memcpy(&req, data, sizeof(req));
+                if (req.type != RelayProtocol::MSG_REGISTER) continue;
+                uint8_t status = relay.registerPeer(req.sessionId, batch->from[i], now);
+                RelayProtocol::makeControl(batch->replies[i], status, req.sessionId);
+                out[outCount++] = {&batch->replies[i], static_cast<int>(sizeof(RelayProtocol::Control)), batch->from[i]};
+            } else {
+                sockaddr_in to;
+                if (relay.route(batch->from[i], now, to)) out[outCount++] = {data, len, to};
+            }
+        }
+        if (outCount > 0) sendBatch(fd, *batch, out, outCount);
+
+        if (now - lastSweep >= 1000) {
+            relay.sweep(now);
+            lastSweep = now;
+        }
+        if (now - lastStats >= 60000) {
+            std::cout << "Sessions: " << relay.activeSessions
+                      << " | Forwarded: " << relay.forwarded << std::endl;
+            lastStats = now;
+        }
+    }
+
+    delete batch;
+    close(fd);
+    return 0;
+}
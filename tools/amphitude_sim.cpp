@@ -0,0 +1,219 @@
+// amphitude-sim: runs local matches headless, as fast as the CPU allows, and
+// reports aggregate results for balancing.
+//
+// Usage: amphitude-sim [--matches N] [--players P] [--seed S] [--threads T]
+//                      [--level file.lvl] [--out report.txt]
+//
+// Every match is the real simulation (Game::simulateTick) with no window,
+// assets, effects or frame pacing; scripted players drive the inputs. Matches
+// are spread over all cores with the job system, each with its own seed
+// (from --seed and the match index) for both the match and the input scripts, so a run
+// gives the same report however many threads play it. Balance values are
+// GameConstants / ABILITIES: change them and rebuild this target to sweep.
+// --threads T counts every thread, this one included (default: one per core).
+
+#define SDL_MAIN_HANDLED
+#include "Game.h"
+#include "Abilities.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int matches = 1000;
+    int players = 2;
+    Uint32 seed = 1;
+    int threads = -1;
+    const char* level = nullptr;
+    const char* out = "sim-report.txt";
+};
+
+/** @brief Outcome of one match. */
+struct MatchResult {
+    int winnerId;   ///< 0 = draw
+    Uint32 ticks;
+    float damage[DAMAGE_SOURCE_COUNT];
+};
+
+Uint32 nextRandom(Uint32& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/**
+ * @brief Simple scripted fighter: goes for a power-up while it has none,
+ * otherwise chases the nearest opponent and attacks when lined up.
+ */
+void scriptInput(Game& game, size_t self, Uint32& rng) {
+    std::vector<Player>& players = game.getPlayers();
+    Player& me = players[self];
+    float myX = me.x + me.width / 2, myY = me.y + me.height / 2;
+
+    // Nearest opponent still standing
+    const Player* target = nullptr;
+    float best = 1e9f;
+    for (const Player& p : players) {
+        if (&p == &me || p.hp <= 0) continue;
+        float d = std::abs(p.x - me.x) + std::abs(p.y - me.y);
+        if (d < best) { best = d; target = &p; }
+    }
+
+    float goalX = target ? target->x + target->width / 2 : myX;
+    float goalY = target ? target->y + target->height / 2 : myY;
+    const EntityStore& pu = game.getPowerUps();
+    if (me.power == POWER_NONE) {
+        for (size_t i = 0; i < pu.size(); ++i) {
+            float d = std::abs(pu.x[i] - me.x) + std::abs(pu.y[i] - me.y);
+            if (d < best) { best = d; goalX = pu.x[i]; goalY = pu.y[i]; }
+        }
+    }
+
+    float dx = goalX - myX, dy = goalY - myY;
+    me.keyLeft = dx < -20;
+    me.keyRight = dx > 20;
+    me.keyDown = false;
+    me.keyJump = (dy < -40 && me.onGround) || nextRandom(rng) % 64 == 0;
+
+    // Attack when lined up: fireballs along the row, everything else up close
+    me.keyAttack = false;
+    if (target) {
+        float tx = target->x - me.x, ty = target->y - me.y;
+        bool facingIt = (tx > 0) == (me.facing > 0);
+        bool inRange = ability(me.power).attack == ATTACK_PROJECTILE ? std::abs(ty) < 40 : std::abs(tx) < 120;
+        me.keyAttack = facingIt && inRange && nextRandom(rng) % 4 == 0;
+    }
+}
+
+MatchResult playMatch(Game& game, Uint32 seed, int numPlayers) {
+    game.startMatch(seed);
+    std::vector<Uint32> rng(numPlayers);
+    for (int i = 0; i < numPlayers; ++i) rng[i] = ((seed * 2654435761u) ^ (0x9E3779B9u * (i + 1))) | 1;
+
+    for (; game.matchRunning(); ) {
+        std::vector<Player>& players = game.getPlayers();
+        for (size_t i = 0; i < players.size(); ++i) {
+            if (players[i].hp > 0) scriptInput(game, i, rng[i]);
+        }
+        game.simulateTick();
+    }
+
+    MatchResult r = {};
+    r.winnerId = game.getWinnerId();
+    r.ticks = game.getSimTick();
+    for (const Player& p : game.getPlayers()) {
+        for (int s = 0; s < DAMAGE_SOURCE_COUNT; ++s) r.damage[s] += p.damageTaken[s];
+    }
+    return r;
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (arg == "--matches") o.matches = atoi(value);
+        else if (arg == "--players") o.players = atoi(value);
+        else if (arg == "--seed") o.seed = static_cast<Uint32>(strtoul(value, nullptr, 10));
+        else if (arg == "--threads") o.threads = atoi(value);
+        else if (arg == "--level") o.level = value;
+        else if (arg == "--out") o.out = value;
+        else return false;
+    }
+    return o.matches > 0 && o.players >= 2 && o.players <= GameConstants::MAX_PLAYERS;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::cerr << "Usage: " << argv[0] << " [--matches N] [--players 2-" << GameConstants::MAX_PLAYERS
+                  << "] [--seed S] [--threads T] [--level file.lvl] [--out report.txt]" << std::endl;
+        return 2;
+    }
+
+    JobSystem jobs;
+    jobs.start(opt.threads < 0 ? -1 : std::max(opt.threads - 1, 0)); // The main thread runs jobs too
+    std::vector<MatchResult> results(opt.matches);
+    std::atomic<bool> levelOk{true}; // Written by whichever jobs fail to load
+
+    // One Game per chunk of matches, reused between its matches
+    const int MATCHES_PER_JOB = 16;
+    auto start = std::chrono::steady_clock::now();
+    jobs.parallelFor(0, opt.matches, MATCHES_PER_JOB, [&](int begin, int end) {
+        Game game;
+        if (!game.initHeadless(opt.players, opt.level)) {
+            levelOk.store(false, std::memory_order_relaxed);
+            return;
+        }
+        for (int m = begin; m < end; ++m) {
+            Random matchSeeds;
+            matchSeeds.seed(opt.seed, static_cast<Uint32>(m));
+            results[m] = playMatch(game, matchSeeds.next(), opt.players);
+        }
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!levelOk) {
+        std::cerr << "Cannot load level " << opt.level << std::endl;
+        return 1;
+    }
+
+    // Aggregate
+    std::vector<int> wins(opt.players + 1, 0); // [0] = draws
+    std::vector<Uint32> lengths;
+    double damage[DAMAGE_SOURCE_COUNT] = {};
+    Uint64 totalTicks = 0;
+    for (const MatchResult& r : results) {
+        wins[r.winnerId >= 0 && r.winnerId <= opt.players ? r.winnerId : 0]++;
+        lengths.push_back(r.ticks);
+        totalTicks += r.ticks;
+        for (int s = 0; s < DAMAGE_SOURCE_COUNT; ++s) damage[s] += r.damage[s];
+    }
+    std::sort(lengths.begin(), lengths.end());
+    double damageTotal = 0;
+    for (double d : damage) damageTotal += d;
+    auto secondsOf = [](Uint32 ticks) { return static_cast<double>(ticks) / GameConstants::TICK_RATE; };
+    const char* SOURCE_NAMES[DAMAGE_SOURCE_COUNT] = {"collision", "ram", "projectile", "fall"};
+
+    std::ofstream out(opt.out, std::ios::trunc);
+    char line[160];
+    snprintf(line, sizeof(line), "matches %d\nplayers %d\nseed %u\nthreads %d\n", opt.matches, opt.players,
+             opt.seed, jobs.workerCount() + 1);
+    out << line;
+    for (int p = 1; p <= opt.players; ++p) {
+        snprintf(line, sizeof(line), "win_rate_p%d %.4f\n", p, static_cast<double>(wins[p]) / opt.matches);
+        out << line;
+    }
+    snprintf(line, sizeof(line), "draw_rate %.4f\n", static_cast<double>(wins[0]) / opt.matches);
+    out << line;
+    snprintf(line, sizeof(line), "match_seconds_avg %.2f\nmatch_seconds_p50 %.2f\nmatch_seconds_p90 %.2f\nmatch_seconds_max %.2f\n",
+             secondsOf(static_cast<Uint32>(totalTicks / opt.matches)), secondsOf(lengths[lengths.size() / 2]),
+             secondsOf(lengths[lengths.size() * 9 / 10]), secondsOf(lengths.back()));
+    out << line;
+    for (int s = 0; s < DAMAGE_SOURCE_COUNT; ++s) {
+        snprintf(line, sizeof(line), "damage_%s_per_match %.2f\ndamage_%s_share %.4f\n", SOURCE_NAMES[s],
+                 damage[s] / opt.matches, SOURCE_NAMES[s], damageTotal > 0 ? damage[s] / damageTotal : 0.0);
+        out << line;
+    }
+    snprintf(line, sizeof(line), "wall_seconds %.3f\nms_per_match %.3f\nticks_per_second %.0f\n", seconds,
+             seconds * 1000.0 / opt.matches, totalTicks / seconds);
+    out << line;
+
+    std::cout << opt.matches << " matches (" << opt.players << " players) in " << seconds << " s, "
+              << seconds * 1000.0 / opt.matches << " ms each on " << jobs.workerCount() + 1
+              << " threads. Report: " << opt.out << std::endl;
+    return out ? 0 : 1;
+}